@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_ATTACKTABLES_H
+#define CHESS_ATTACKTABLES_H
+
+#include <array>
+#include <cstddef>
+#include "Bitboard.h"
+#include "Color.h"
+
+namespace AttackTableGenerator {
+    /**
+     * For every field, the set of fields reached by the given (rank, file) offsets without leaving the board
+     */
+    template<size_t Count>
+    constexpr std::array<Bitboard, 64> generate(const int (&offsets)[Count][2]) {
+        std::array<Bitboard, 64> table{};
+        for (int index = 0; index < 64; index++) {
+            for (const auto &offset: offsets) {
+                auto target = Square(index).offset(offset[0], offset[1]);
+                if (target.isValid()) {
+                    table[index] |= squareBit(target);
+                }
+            }
+        }
+        return table;
+    }
+
+    /**
+     * For every pair of fields on a common rank, file or diagonal, the set of fields strictly between them
+     */
+    constexpr std::array<std::array<Bitboard, 64>, 64> generateBetween() {
+        constexpr int directions[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        std::array<std::array<Bitboard, 64>, 64> table{};
+        for (int index = 0; index < 64; index++) {
+            for (const auto &direction: directions) {
+                Bitboard passed = 0;
+                for (auto target = Square(index).offset(direction[0], direction[1]);
+                     target.isValid(); target = target.offset(direction[0], direction[1])) {
+                    table[index][target.getIndex()] = passed;
+                    passed |= squareBit(target);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr int KNIGHT_OFFSETS[8][2] = {{-2, -1}, {-1, -2}, {1, -2}, {2, -1}, {2, 1}, {1, 2}, {-1, 2}, {-2, 1}};
+    constexpr int KING_OFFSETS[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+    constexpr int WHITE_PAWN_OFFSETS[2][2] = {{1, -1}, {1, 1}};
+    constexpr int BLACK_PAWN_OFFSETS[2][2] = {{-1, -1}, {-1, 1}};
+}
+
+/**
+ * Fields attacked by knights, kings and pawns from every field and fields between pairs of fields on a common line,
+ * computed at compile time
+ * https://www.chessprogramming.org/Knight_Pattern
+ */
+class AttackTables {
+private:
+    static constexpr std::array<Bitboard, 64> knight = AttackTableGenerator::generate(
+            AttackTableGenerator::KNIGHT_OFFSETS);
+    static constexpr std::array<Bitboard, 64> king = AttackTableGenerator::generate(
+            AttackTableGenerator::KING_OFFSETS);
+    static constexpr std::array<std::array<Bitboard, 64>, 2> pawn = {
+            AttackTableGenerator::generate(AttackTableGenerator::WHITE_PAWN_OFFSETS),
+            AttackTableGenerator::generate(AttackTableGenerator::BLACK_PAWN_OFFSETS)
+    };
+    static constexpr std::array<std::array<Bitboard, 64>, 64> betweenFields = AttackTableGenerator::generateBetween();
+
+public:
+    static constexpr Bitboard knightAttacks(Square square) {
+        return knight[square.getIndex()];
+    }
+
+    static constexpr Bitboard kingAttacks(Square square) {
+        return king[square.getIndex()];
+    }
+
+    /**
+     * Fields attacked by a pawn of the given color standing on the field
+     */
+    static constexpr Bitboard pawnAttacks(Color color, Square square) {
+        return pawn[static_cast<int>(color)][square.getIndex()];
+    }
+
+    /**
+     * Fields strictly between the two, empty if they are not on a common line
+     */
+    static constexpr Bitboard between(Square from, Square to) {
+        return AttackTables::betweenFields[from.getIndex()][to.getIndex()];
+    }
+};
+
+static_assert(AttackTables::knightAttacks(Square::at(0, 0)) == (squareBit(Square::at(1, 2)) | squareBit(Square::at(2, 1))),
+              "a knight in the corner attacks two fields");
+static_assert(AttackTables::kingAttacks(Square::at(3, 3)) == 0x1C141C0000ULL, "a king in the center attacks eight fields");
+static_assert(AttackTables::pawnAttacks(Color::BLACK, Square::at(3, 0)) == squareBit(Square::at(2, 1)),
+              "pawns on the edge attack one field");
+static_assert(AttackTables::between(Square::at(0, 0), Square::at(3, 3)) ==
+              (squareBit(Square::at(1, 1)) | squareBit(Square::at(2, 2))), "fields between on a diagonal");
+static_assert(AttackTables::between(Square::at(0, 0), Square::at(1, 2)) == 0, "no fields between off a common line");
+
+
+#endif //CHESS_ATTACKTABLES_H
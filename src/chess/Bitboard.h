@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_BITBOARD_H
+#define CHESS_BITBOARD_H
+
+#include <cstdint>
+#include "Square.h"
+
+/**
+ * Set of fields, bit n set for the field with Square index n
+ */
+using Bitboard = uint64_t;
+
+constexpr Bitboard squareBit(Square square) {
+    return Bitboard(1) << square.getIndex();
+}
+
+/**
+ * Remove the lowest field from a non-empty set and return it
+ */
+inline Square popLowestSquare(Bitboard &bitboard) {
+    auto index = __builtin_ctzll(bitboard);
+    bitboard &= bitboard - 1;
+    return Square(index);
+}
+
+
+#endif //CHESS_BITBOARD_H
@@ -19,28 +19,75 @@
 #include "ChessExceptions.h"
 
 Board::Board() {
-    this->allPieces = {};
     this->blackKing = nullptr;
     this->whiteKing = nullptr;
+    this->allPieces.reserve(BoardArena::PIECES_PER_BLOCK);
 
     for (int row = 0; row < BOARD_SIZE; ++row) {
         for (int col = 0; col < BOARD_SIZE; ++col) {
-            this->fields[row][col] = new Field(nullptr, Position(row + 1, col + 1), this);
+            auto index = row * BOARD_SIZE + col;
+            this->fields[row][col] = arena.createField(index, nullptr, Position(Square(index)), this);
         }
     }
 };
 
+Board::Board(const Board &other) : Board() {
+    // the pieces are put on the same fields, so the codes and counters describing them are the same
+    squares = other.squares;
+    occupied = other.occupied;
+    occupiedByColor = other.occupiedByColor;
+    pieceCounts = other.pieceCounts;
+    bishopCounts = other.bishopCounts;
+    for (auto otherPiece: other.allPieces) {
+        auto otherField = otherPiece->getField();
+        if (otherField == nullptr) {
+            continue;
+        }
+        auto square = otherField->getPosition().toSquare();
+        auto code = squares[square.getIndex()];
+        auto field = getField(square);
+        auto piece = createPiece(pieceTypeOf(code), pieceColorOf(code), field);
+        field->attachPiece(piece);
+        if (otherPiece == other.whiteKing) {
+            whiteKing = piece;
+        } else if (otherPiece == other.blackKing) {
+            blackKing = piece;
+        }
+    }
+}
+
 Board::~Board() {
     for (auto piecePtr: allPieces) {
-        delete piecePtr;
+        arena.destroyPiece(piecePtr);
     }
+}
 
-    for (int row = 0; row < BOARD_SIZE; ++row) {
-        for (int col = 0; col < BOARD_SIZE; ++col) {
-            delete this->fields[row][col];
-        }
+Piece *Board::createPiece(PieceType type, Color color, Field *field) {
+    Piece *piece;
+    switch (type) {
+        case PieceType::PAWN:
+            piece = arena.createPiece<Pawn>(color, field);
+            break;
+        case PieceType::ROOK:
+            piece = arena.createPiece<Rook>(color, field);
+            break;
+        case PieceType::BISHOP:
+            piece = arena.createPiece<Bishop>(color, field);
+            break;
+        case PieceType::KNIGHT:
+            piece = arena.createPiece<Knight>(color, field);
+            break;
+        case PieceType::QUEEN:
+            piece = arena.createPiece<Queen>(color, field);
+            break;
+        case PieceType::KING:
+            piece = arena.createPiece<King>(color, field);
+            break;
+        default:
+            throw IllegalMoveException("Invalid piece type");
     }
-
+    allPieces.push_back(piece);
+    return piece;
 }
 
 std::string Board::toString() const {
@@ -70,44 +117,83 @@ Board *Board::emptyBoard() {
     return new Board();
 }
 
+Board *Board::fromSquares(const BoardSquares &squares) {
+    auto board = Board::emptyBoard();
+    // from the 8th rank down, in the order of FEN
+    for (int rank = BOARD_SIZE - 1; rank >= 0; rank--) {
+        for (int file = 0; file < BOARD_SIZE; file++) {
+            auto square = Square::at(rank, file);
+            auto code = squares[square.getIndex()];
+            if (code == NO_PIECE) {
+                continue;
+            }
+            auto field = board->getField(square);
+            auto color = pieceColorOf(code);
+            Piece *piece;
+            try {
+                piece = board->createPiece(pieceTypeOf(code), color, field);
+            } catch (const IllegalMoveException &) {
+                delete board;
+                throw IllegalMoveException("Invalid piece code");
+            }
+            if (pieceTypeOf(code) == PieceType::KING) {
+                if (color == Color::WHITE) {
+                    board->setWhiteKing(piece);
+                } else {
+                    board->setBlackKing(piece);
+                }
+            }
+            field->setPiece(piece);
+        }
+    }
+    return board;
+}
+
 Field *Board::getField(Position position) const {
     return fields[position.getRow() - 1][position.getCol() - 1];
 }
 
+Field *Board::getField(Square square) const {
+    return fields[square.getRank()][square.getFile()];
+}
 
-Board *Board::startingBoard() {
-    auto board = Board::emptyBoard();
+Piece *Board::getPiece(Square square) const {
+    return getField(square)->getPiece();
+}
 
-    for (int col = 1; col <= BOARD_SIZE; col++) {
-        board->allPieces.push_back(new Pawn(Color::WHITE, board->getField(Position(2, col))));
-    }
+const BoardSquares &Board::getSquares() const {
+    return squares;
+}
 
-    for (int col = 1; col <= BOARD_SIZE; col++) {
-        board->allPieces.push_back(new Pawn(Color::BLACK, board->getField(Position(7, col))));
-    }
+Bitboard Board::getOccupied() const {
+    return occupied;
+}
+
+Bitboard Board::getOccupied(Color color) const {
+    return occupiedByColor[static_cast<int>(color)];
+}
 
-    board->allPieces.push_back(new Rook(Color::WHITE, board->getField(Position::fromString("a1"))));
-    board->allPieces.push_back(new Knight(Color::WHITE, board->getField(Position::fromString("b1"))));
-    board->allPieces.push_back(new Bishop(Color::WHITE, board->getField(Position::fromString("c1"))));
-    board->allPieces.push_back(new Queen(Color::WHITE, board->getField(Position::fromString("d1"))));
-    board->allPieces.push_back(new Bishop(Color::WHITE, board->getField(Position::fromString("f1"))));
-    board->allPieces.push_back(new Knight(Color::WHITE, board->getField(Position::fromString("g1"))));
-    board->allPieces.push_back(new Rook(Color::WHITE, board->getField(Position::fromString("h1"))));
 
-    board->allPieces.push_back(new Rook(Color::BLACK, board->getField(Position::fromString("a8"))));
-    board->allPieces.push_back(new Knight(Color::BLACK, board->getField(Position::fromString("b8"))));
-    board->allPieces.push_back(new Bishop(Color::BLACK, board->getField(Position::fromString("c8"))));
-    board->allPieces.push_back(new Queen(Color::BLACK, board->getField(Position::fromString("d8"))));
-    board->allPieces.push_back(new Bishop(Color::BLACK, board->getField(Position::fromString("f8"))));
-    board->allPieces.push_back(new Knight(Color::BLACK, board->getField(Position::fromString("g8"))));
-    board->allPieces.push_back(new Rook(Color::BLACK, board->getField(Position::fromString("h8"))));
+Board *Board::startingBoard() {
+    auto board = Board::emptyBoard();
 
-    auto whiteKing = new King(Color::WHITE, board->getField(Position::fromString("e1")));
-    auto blackKing = new King(Color::BLACK, board->getField(Position::fromString("e8")));
-    board->whiteKing = whiteKing;
-    board->blackKing = blackKing;
-    board->allPieces.push_back(whiteKing);
-    board->allPieces.push_back(blackKing);
+    for (auto color: {Color::WHITE, Color::BLACK}) {
+        auto pieceRow = (color == Color::WHITE) ? 1 : BOARD_SIZE;
+        auto pawnRow = (color == Color::WHITE) ? 2 : BOARD_SIZE - 1;
+        for (int col = 1; col <= BOARD_SIZE; col++) {
+            board->createPiece(PieceType::PAWN, color, board->getField(Position(pawnRow, col)));
+        }
+        int col = 1;
+        for (auto type: {PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN, PieceType::KING,
+                         PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK}) {
+            auto piece = board->createPiece(type, color, board->getField(Position(pieceRow, col++)));
+            if (type == PieceType::KING && color == Color::WHITE) {
+                board->whiteKing = piece;
+            } else if (type == PieceType::KING) {
+                board->blackKing = piece;
+            }
+        }
+    }
 
     // Set pointers in both ways
     for (auto piece: board->allPieces) {
@@ -136,6 +222,7 @@ void Board::makeMove(const Move &move) {
     if (capturedPiece != nullptr) {
         capturedPiece->getField()->setPiece(nullptr);
         capturedPiece->takeOffField();
+        takenPieces.push_back(capturedPiece);
     }
 
     if (move.getPromoteTo() == PieceType::NONE) {
@@ -143,9 +230,8 @@ void Board::makeMove(const Move &move) {
         sourceField->setPiece(nullptr);
         sourcePiece->setField(targetField);
         if (move.isCastling()) {
-            auto rookCol = (move.isLongCastle()) ? 1 : 8;
-            auto row = (move.getTo().getRow());
-            auto castledRook = getField(Position(row, rookCol))->getPiece();
+            auto rookFile = (move.isLongCastle()) ? 0 : 7;
+            auto castledRook = getPiece(Square::at(move.getToSquare().getRank(), rookFile));
             makeMove(Move::generateCastlingComplement(castledRook, false));
         }
     } else
@@ -157,6 +243,46 @@ std::vector<Piece *> &Board::getAllPieces() {
     return allPieces;
 }
 
+int Board::getPieceCount(Color color, PieceType type) const {
+    return pieceCounts[static_cast<int>(color)][static_cast<int>(type)];
+}
+
+int Board::getBishopCount(Color color, bool lightFields) const {
+    return bishopCounts[static_cast<int>(color)][lightFields ? 1 : 0];
+}
+
+bool Board::isLightField(const Position &position) {
+    return (position.getRow() + position.getCol()) % 2 == 1;
+}
+
+void Board::updateField(const Piece *removed, const Piece *added, const Position &position) {
+    if (removed == added) {
+        return;
+    }
+    squares[position.getIndex()] = (added != nullptr) ? makePieceCode(added->getColor(), added->getType()) : NO_PIECE;
+    auto bit = squareBit(position.toSquare());
+    if (removed != nullptr) {
+        occupied &= ~bit;
+        occupiedByColor[static_cast<int>(removed->getColor())] &= ~bit;
+    }
+    if (added != nullptr) {
+        occupied |= bit;
+        occupiedByColor[static_cast<int>(added->getColor())] |= bit;
+    }
+    if (removed != nullptr) {
+        pieceCounts[static_cast<int>(removed->getColor())][static_cast<int>(removed->getType())]--;
+        if (removed->getType() == PieceType::BISHOP) {
+            bishopCounts[static_cast<int>(removed->getColor())][isLightField(position) ? 1 : 0]--;
+        }
+    }
+    if (added != nullptr) {
+        pieceCounts[static_cast<int>(added->getColor())][static_cast<int>(added->getType())]++;
+        if (added->getType() == PieceType::BISHOP) {
+            bishopCounts[static_cast<int>(added->getColor())][isLightField(position) ? 1 : 0]++;
+        }
+    }
+}
+
 Piece *Board::getBlackKing() const {
     return blackKing;
 }
@@ -168,31 +294,27 @@ Piece *Board::getWhiteKing() const {
 void Board::executePromotion(const Move &move) {
     auto sourcePiece = move.getPiece();
     auto targetField = this->getField(move.getTo());
-    Piece *promotedPiece;
-    switch (move.getPromoteTo()) {
-        case PieceType::QUEEN: {
-            promotedPiece = new Queen(sourcePiece->getColor(), targetField);
-            break;
-        }
-        case PieceType::ROOK: {
-            promotedPiece = new Rook(sourcePiece->getColor(), targetField);
-            break;
-        }
-        case PieceType::BISHOP: {
-            promotedPiece = new Bishop(sourcePiece->getColor(), targetField);
-            break;
-        }
-        case PieceType::KNIGHT: {
-            promotedPiece = new Knight(sourcePiece->getColor(), targetField);
-            break;
-        }
-        default:
-            throw IllegalMoveException("Cannot promote to this piece!");
+    if (move.getPromoteTo() == PieceType::KING || move.getPromoteTo() == PieceType::PAWN) {
+        throw IllegalMoveException("Cannot promote to this piece!");
     }
+    auto promotedPiece = createPiece(move.getPromoteTo(), sourcePiece->getColor(), targetField);
     promotedPiece->getField()->setPiece(promotedPiece);
     sourcePiece->getField()->setPiece(nullptr);
     sourcePiece->takeOffField();
-    allPieces.push_back(promotedPiece);
+    takenPieces.push_back(sourcePiece);
+}
+
+Piece *Board::restorePiece(PieceType type, Color color) {
+    if (!takenPieces.empty() && takenPieces.back()->getType() == type && takenPieces.back()->getColor() == color) {
+        auto piece = takenPieces.back();
+        takenPieces.pop_back();
+        return piece;
+    }
+
+    if (type == PieceType::KING) {
+        throw IllegalMoveException("Cannot restore this piece!");
+    }
+    return createPiece(type, color, nullptr);
 }
 
 void Board::setBlackKing(Piece *blackKing) {
@@ -210,12 +332,19 @@ void Board::reverseMove(const Move &move, bool isEnPassant) {
     auto capturedPiece = move.getCapturedPiece();
     auto movedPiece = move.getPiece();
 
+    // the pieces are already off the stack if they were found by restorePiece
+    for (auto piece: {movedPiece, capturedPiece}) {
+        if (piece != nullptr && !takenPieces.empty() && takenPieces.back() == piece) {
+            takenPieces.pop_back();
+        }
+    }
 
     if (move.getPromoteTo() != PieceType::NONE) {
-        // if the move was a promotion, remove the promoted piece from the board and deallocate the memory
+        // if the move was a promotion, remove the promoted piece from the board and return its slot to the arena
         allPieces.erase(std::remove(allPieces.begin(), allPieces.end(), pieceOnSourceField));
+        sourceField->setPiece(nullptr);
         pieceOnSourceField->takeOffField();
-        delete pieceOnSourceField;
+        arena.destroyPiece(pieceOnSourceField);
     }
 
     // set the moved piece to move.getFrom() and update the pointer of move.getTo()
@@ -225,16 +354,15 @@ void Board::reverseMove(const Move &move, bool isEnPassant) {
 
     if (move.isCastling()) {
         // reverse castling complement accordingly
-        auto rookCol = (move.isLongCastle()) ? 4 : 6;
-        auto row = (move.getTo().getRow());
-        auto castledRook = getField(Position(row, rookCol))->getPiece();
+        auto rookFile = (move.isLongCastle()) ? 3 : 5;
+        auto castledRook = getPiece(Square::at(move.getToSquare().getRank(), rookFile));
         reverseMove(Move::generateCastlingComplement(castledRook, true), false);
     }
 
 
     if (capturedPiece != nullptr) {
         if (isEnPassant)
-            sourceField = getField(Position(move.getFrom().getRow(), move.getTo().getCol()));
+            sourceField = getField(Square::at(move.getFromSquare().getRank(), move.getToSquare().getFile()));
 
         // restore captured piece
         capturedPiece->setField(sourceField);
@@ -8,11 +8,18 @@
 #ifndef CHESS_BOARD_H
 #define CHESS_BOARD_H
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include "Field.h"
+#include "BoardArena.h"
 #include "Move.h"
 #include "constants.h"
+#include "Color.h"
+#include "PieceCode.h"
+#include "Bitboard.h"
+#include "pieces/PieceType.h"
 #include "pieces/Piece.h"
 
 class Piece;
@@ -23,24 +30,92 @@ class Field;
 
 class Board {
 private:
+    /**
+     * Owns the fields and the pieces, declared first so that it outlives them
+     */
+    BoardArena arena;
     std::array<std::array<Field *, BOARD_SIZE>, BOARD_SIZE> fields{};
     std::vector<Piece *> allPieces;
+    /**
+     * Pieces taken off the board by the moves - captured pieces and promoted pawns - the most recent last,
+     * so that undoing the moves puts back the same objects
+     */
+    std::vector<Piece *> takenPieces;
     Piece *blackKing;
     Piece *whiteKing;
+    /**
+     * Codes of the pieces on the fields, mirroring the piece objects for the move generator
+     */
+    BoardSquares squares{};
+    Bitboard occupied = 0;
+    std::array<Bitboard, 2> occupiedByColor{};
+    /**
+     * Number of pieces on the board by color and type, and of bishops by color and color of their field
+     * (0 - dark, 1 - light), kept up to date by the fields whenever a piece is put on or taken off one
+     */
+    std::array<std::array<uint8_t, 7>, 2> pieceCounts{};
+    std::array<std::array<uint8_t, 2>, 2> bishopCounts{};
+
+    friend class Field;
+
+    /**
+     * Update the piece codes and material counters when a field's piece is replaced
+     */
+    void updateField(const Piece *removed, const Piece *added, const Position &position);
+
+    /**
+     * New piece object in the board's arena, added to all pieces. The field is not updated and kings are not
+     * registered as the board's kings.
+     */
+    Piece *createPiece(PieceType type, Color color, Field *field);
 
 public:
     Board();
 
     ~Board();
 
+    /**
+     * Board with new piece objects in the same places as the other board's pieces, in the same order. Pieces off
+     * the other board are not copied, restorePiece creates them again when they are needed.
+     */
+    Board(const Board &other);
+
+    Board &operator=(const Board &) = delete;
+
     void makeMove(const Move &move);
 
     void reverseMove(const Move &move, bool isEnPassant=false);
 
     void executePromotion(const Move &move);
 
+    /**
+     * Piece of the given type and color most recently taken off the board - a captured piece or a promoted pawn -
+     * to be put back when the last move is undone. Creates a new one if the last taken piece is not of that type
+     * and color, e.g. for moves made before the board was copied.
+     */
+    Piece *restorePiece(PieceType type, Color color);
+
     Field *getField(Position position) const;
 
+    Field *getField(Square square) const;
+
+    /**
+     * Piece on the field or nullptr if it is empty
+     */
+    Piece *getPiece(Square square) const;
+
+    const BoardSquares &getSquares() const;
+
+    /**
+     * Set of the fields with a piece on them
+     */
+    Bitboard getOccupied() const;
+
+    /**
+     * Set of the fields with a piece of the given color on them
+     */
+    Bitboard getOccupied(Color color) const;
+
     Piece *getBlackKing() const;
 
     Piece *getWhiteKing() const;
@@ -51,8 +126,22 @@ public:
 
     std::vector<Piece *> &getAllPieces();
 
+    int getPieceCount(Color color, PieceType type) const;
+
+    /**
+     * @param lightFields whether to count bishops on light or dark fields
+     */
+    int getBishopCount(Color color, bool lightFields) const;
+
+    static bool isLightField(const Position &position);
+
     static Board *emptyBoard();
 
+    /**
+     * Board with new piece objects put on the fields according to the piece codes
+     */
+    static Board *fromSquares(const BoardSquares &squares);
+
     /**
      * Create new board with all pieces set in their initial positions
      */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_BOARDARENA_H
+#define CHESS_BOARDARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "Field.h"
+#include "constants.h"
+
+/**
+ * Memory of the objects which belong to a board - its 64 fields and its pieces. The fields and the first 32 pieces
+ * are constructed inside the arena, which is a member of the board, so a board with all of its pieces is a single
+ * allocation. Pieces beyond that, created by promotions, come from blocks of 32 more. Slots of destroyed pieces
+ * are reused.
+ */
+class BoardArena {
+public:
+    static constexpr size_t PIECE_SLOT_SIZE = 32;
+    static constexpr size_t PIECES_PER_BLOCK = 32;
+
+private:
+    union PieceSlot {
+        PieceSlot *nextFree;
+        alignas(std::max_align_t) unsigned char storage[PIECE_SLOT_SIZE];
+    };
+    using PieceBlock = std::array<PieceSlot, PIECES_PER_BLOCK>;
+
+    std::array<std::aligned_storage_t<sizeof(Field), alignof(Field)>, BOARD_SIZE * BOARD_SIZE> fieldStorage;
+    PieceBlock initialBlock;
+    std::vector<std::unique_ptr<PieceBlock>> extraBlocks;
+    PieceBlock *currentBlock = &initialBlock;
+    size_t usedSlots = 0;
+    PieceSlot *freeSlots = nullptr;
+
+    void *allocatePiece() {
+        if (freeSlots != nullptr) {
+            auto slot = freeSlots;
+            freeSlots = slot->nextFree;
+            return slot;
+        }
+        if (usedSlots == PIECES_PER_BLOCK) {
+            extraBlocks.push_back(std::make_unique<PieceBlock>());
+            currentBlock = extraBlocks.back().get();
+            usedSlots = 0;
+        }
+        return &(*currentBlock)[usedSlots++];
+    }
+
+public:
+    BoardArena() = default;
+
+    BoardArena(const BoardArena &) = delete;
+
+    BoardArena &operator=(const BoardArena &) = delete;
+
+    /**
+     * Construct the field with the given index, fields need no destruction
+     */
+    template<class... Args>
+    Field *createField(size_t index, Args &&... args) {
+        static_assert(std::is_trivially_destructible<Field>::value, "fields are never destroyed");
+        return new(&fieldStorage[index]) Field(std::forward<Args>(args)...);
+    }
+
+    template<class PieceClass>
+    Piece *createPiece(Color color, Field *field) {
+        static_assert(sizeof(PieceClass) <= PIECE_SLOT_SIZE && alignof(PieceClass) <= alignof(PieceSlot),
+                      "every piece must fit in a slot");
+        return new(allocatePiece()) PieceClass(color, field);
+    }
+
+    void destroyPiece(Piece *piece) {
+        piece->~Piece();
+        auto slot = reinterpret_cast<PieceSlot *>(piece);
+        slot->nextFree = freeSlots;
+        freeSlots = slot;
+    }
+};
+
+
+#endif //CHESS_BOARDARENA_H
@@ -8,7 +8,9 @@
 #ifndef CHESS_CHESSEXCEPTIONS_H
 #define CHESS_CHESSEXCEPTIONS_H
 
+#include <cstddef>
 #include <exception>
+#include <string>
 #include <utility>
 
 class ChessException : public std::exception {
@@ -31,6 +33,35 @@ class PieceNotOnBoardException : public ChessException {
 };
 
 class FenException : public ChessException {
+private:
+    size_t offset = 0;
+public:
+    using ChessException::ChessException;
+
+    /**
+     * @param offset index of the character of the FEN string at which the error was found
+     */
+    FenException(const std::string &msg, size_t offset) :
+            ChessException("Invalid FEN at character " + std::to_string(offset) + " - " + msg), offset(offset) {}
+
+    [[nodiscard]] size_t getOffset() const {
+        return offset;
+    }
+};
+
+class PgnException : public ChessException {
+    using ChessException::ChessException;
+};
+
+class ArchiveException : public ChessException {
+    using ChessException::ChessException;
+};
+
+class EpdException : public ChessException {
+    using ChessException::ChessException;
+};
+
+class SessionException : public ChessException {
     using ChessException::ChessException;
 };
 
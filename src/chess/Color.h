@@ -9,7 +9,9 @@
 #define CHESS_COLOR_H
 
 
-enum class Color {
+#include <cstdint>
+
+enum class Color : uint8_t {
     WHITE,
     BLACK,
 };
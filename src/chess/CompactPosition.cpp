@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "CompactPosition.h"
+#include "constants.h"
+
+const char *CompactPosition::checkKings(const BoardSquares &squares) {
+    // plain comparisons, so the loop is vectorized
+    int whiteKings = 0;
+    int blackKings = 0;
+    for (auto code: squares) {
+        whiteKings += (code == makePieceCode(Color::WHITE, PieceType::KING));
+        blackKings += (code == makePieceCode(Color::BLACK, PieceType::KING));
+    }
+    if (whiteKings != 1 || blackKings != 1) {
+        return "exactly one king of each color is required";
+    }
+    return nullptr;
+}
+
+bool CompactPosition::hasCastlingPieces(const BoardSquares &squares, uint8_t castlingRight) {
+    auto color = (castlingRight & (GameState::WHITE_KINGSIDE | GameState::WHITE_QUEENSIDE)) ? Color::WHITE
+                                                                                            : Color::BLACK;
+    auto backRank = (color == Color::WHITE) ? 0 : BOARD_SIZE - 1;
+    auto rookFile = (castlingRight & (GameState::WHITE_KINGSIDE | GameState::BLACK_KINGSIDE)) ? BOARD_SIZE - 1 : 0;
+    return squares[Square::at(backRank, 4).getIndex()] == makePieceCode(color, PieceType::KING) &&
+           squares[Square::at(backRank, rookFile).getIndex()] == makePieceCode(color, PieceType::ROOK);
+}
+
+const char *CompactPosition::checkEnPassant(const BoardSquares &squares, Color sideToMove, Square target) {
+    auto opponent = (sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    auto targetRank = (sideToMove == Color::WHITE) ? BOARD_SIZE - 3 : 2;
+    if (!target.isValid() || target.getRank() != targetRank) {
+        return "en passant target field must be on the 6th rank for white and the 3rd rank for black";
+    }
+    auto pawnDirection = (opponent == Color::WHITE) ? 1 : -1;
+    if (squares[target.offset(pawnDirection, 0).getIndex()] != makePieceCode(opponent, PieceType::PAWN)) {
+        return "en passant target field without the opponent's pawn behind it";
+    }
+    if (squares[target.getIndex()] != NO_PIECE ||
+        squares[target.offset(-pawnDirection, 0).getIndex()] != NO_PIECE) {
+        return "en passant target field and the field the pawn came from must be empty";
+    }
+    return nullptr;
+}
+
+const char *CompactPosition::validate() const {
+    if (auto message = checkKings(squares)) {
+        return message;
+    }
+    bool pawnOnBackRank = false;
+    for (int file = 0; file < BOARD_SIZE; file++) {
+        for (auto code: {squares[file], squares[(BOARD_SIZE - 1) * BOARD_SIZE + file]}) {
+            pawnOnBackRank |= (pieceTypeOf(code) == PieceType::PAWN);
+        }
+    }
+    if (pawnOnBackRank) {
+        return "pawns cannot stand on the 1st or 8th rank";
+    }
+    for (auto right: {GameState::WHITE_KINGSIDE, GameState::WHITE_QUEENSIDE, GameState::BLACK_KINGSIDE,
+                      GameState::BLACK_QUEENSIDE}) {
+        if (state.hasCastlingRight(right) && !hasCastlingPieces(squares, right)) {
+            return "castling right without the king and the rook on their initial fields";
+        }
+    }
+    if (state.enPassantSquare != GameState::NO_EN_PASSANT) {
+        return checkEnPassant(squares, state.sideToMove, state.getEnPassantSquare());
+    }
+    return nullptr;
+}
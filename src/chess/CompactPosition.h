@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_COMPACTPOSITION_H
+#define CHESS_COMPACTPOSITION_H
+
+#include <type_traits>
+#include "PieceCode.h"
+#include "GameState.h"
+#include "Square.h"
+
+/**
+ * Position as plain data - the piece codes of the fields and the state which cannot be read from the board.
+ * Filled by FENParser::parsePosition without any allocation, turned into a playable Game by its constructor.
+ */
+struct CompactPosition {
+    BoardSquares squares;
+    GameState state;
+
+    /**
+     * @return message of the broken rule if there is not exactly one king of each color, nullptr otherwise
+     */
+    static const char *checkKings(const BoardSquares &squares);
+
+    /**
+     * Whether the king and the rook of the castling right stand on their initial fields
+     */
+    static bool hasCastlingPieces(const BoardSquares &squares, uint8_t castlingRight);
+
+    /**
+     * Whether the en passant target field fits the side to move - the opponent's pawn which has just moved two
+     * fields stands behind it, and the target and the field the pawn came from are empty
+     * @return message of the broken rule or nullptr
+     */
+    static const char *checkEnPassant(const BoardSquares &squares, Color sideToMove, Square target);
+
+    /**
+     * The checks of a FEN string applied to the whole position - the kings, no pawns on the 1st or 8th rank,
+     * the pieces of every castling right and the en passant target field
+     * @return message of the first broken rule or nullptr if the position can be played
+     */
+    const char *validate() const;
+};
+
+static_assert(std::is_trivially_copyable<CompactPosition>::value, "CompactPosition must stay trivially copyable");
+
+
+#endif //CHESS_COMPACTPOSITION_H
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// the explicit initialization makes the query valid also in static initializers run before libgcc's own
+#define CHESS_X86_FEATURES(name) (__builtin_cpu_init(), __builtin_cpu_supports(name))
+#else
+#define CHESS_X86_FEATURES(name) false
+#endif
+
+bool CpuFeatures::hasPopcnt() {
+    static const bool supported = CHESS_X86_FEATURES("popcnt");
+    return supported;
+}
+
+bool CpuFeatures::hasBmi2() {
+    static const bool supported = CHESS_X86_FEATURES("bmi2");
+    return supported;
+}
+
+bool CpuFeatures::hasAvx2() {
+    static const bool supported = CHESS_X86_FEATURES("avx2");
+    return supported;
+}
+
+std::string CpuFeatures::describe() {
+    std::string result;
+    for (const auto &feature: {std::make_pair(hasPopcnt(), "popcnt"),
+                               std::make_pair(hasBmi2(), "bmi2"),
+                               std::make_pair(hasAvx2(), "avx2")}) {
+        if (feature.first) {
+            result += result.empty() ? feature.second : std::string(" ") + feature.second;
+        }
+    }
+    return result.empty() ? "generic" : result;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_CPUFEATURES_H
+#define CHESS_CPUFEATURES_H
+
+#include <string>
+
+/**
+ * Instruction set extensions of the processor the program runs on, detected with CPUID.
+ * The library is built for generic x86-64, kernels using the extensions are picked at runtime based on these
+ * and fall back to portable code on other processors and architectures.
+ */
+class CpuFeatures {
+public:
+    static bool hasPopcnt();
+
+    static bool hasBmi2();
+
+    static bool hasAvx2();
+
+    /**
+     * Names of the detected extensions separated by spaces, "generic" if there are none
+     */
+    static std::string describe();
+};
+
+
+#endif //CHESS_CPUFEATURES_H
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <exception>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EpdReader.h"
+#include "ChessExceptions.h"
+
+namespace {
+    /**
+     * Call the visitor for the operations until it returns false. Operations end with a semicolon which is not
+     * inside a quoted string.
+     */
+    template<class Visitor>
+    void visitOperations(std::string_view operations, const Visitor &visitor) {
+        size_t offset = 0;
+        while (offset < operations.size()) {
+            if (operations[offset] == ' ' || operations[offset] == ';') {
+                offset++;
+                continue;
+            }
+
+            auto opcodeStart = offset;
+            while (offset < operations.size() && operations[offset] != ' ' && operations[offset] != ';') {
+                offset++;
+            }
+            auto opcode = operations.substr(opcodeStart, offset - opcodeStart);
+
+            while (offset < operations.size() && operations[offset] == ' ') {
+                offset++;
+            }
+            auto operandsStart = offset;
+            bool quoted = false;
+            while (offset < operations.size() && (quoted || operations[offset] != ';')) {
+                if (operations[offset] == '"') {
+                    quoted = !quoted;
+                }
+                offset++;
+            }
+            auto operands = operations.substr(operandsStart, offset - operandsStart);
+            while (!operands.empty() && operands.back() == ' ') {
+                operands.remove_suffix(1);
+            }
+            if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"' &&
+                operands.find('"', 1) == operands.size() - 1) {
+                operands = operands.substr(1, operands.size() - 2);
+            }
+
+            if (!visitor(opcode, operands)) {
+                return;
+            }
+        }
+    }
+
+    void readClock(const EpdRecord &record, std::string_view opcode, uint16_t &clock) {
+        auto operands = record.getOperation(opcode);
+        if (operands) {
+            std::from_chars(operands->data(), operands->data() + operands->size(), clock);
+        }
+    }
+}
+
+EpdRecord EpdRecord::parse(std::string_view line) {
+    EpdRecord record{};
+    record.line = line;
+    record.error = FENParser::parseEpd(line, record.position, record.operations);
+    if (!record.error) {
+        readClock(record, "hmvc", record.position.state.halfmoveClock);
+        readClock(record, "fmvn", record.position.state.fullmoveNumber);
+    }
+    return record;
+}
+
+void EpdRecord::forEachOperation(
+        const std::function<void(std::string_view opcode, std::string_view operands)> &visitor) const {
+    visitOperations(operations, [&visitor](std::string_view opcode, std::string_view operands) {
+        visitor(opcode, operands);
+        return true;
+    });
+}
+
+std::optional<std::string_view> EpdRecord::getOperation(std::string_view opcode) const {
+    std::optional<std::string_view> found;
+    visitOperations(operations, [&](std::string_view currentOpcode, std::string_view operands) {
+        if (currentOpcode == opcode) {
+            found = operands;
+        }
+        return !found;
+    });
+    return found;
+}
+
+
+EpdReader::EpdReader(const std::string &path) : data(nullptr), size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw EpdException("Cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw EpdException("Cannot read " + path + ": " + strerror(errno));
+    }
+
+    size = fileStat.st_size;
+    if (size == 0) {
+        ::close(fd);
+        return;
+    }
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw EpdException("Cannot map " + path + ": " + strerror(errno));
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(mapping);
+}
+
+EpdReader::~EpdReader() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+std::string_view EpdReader::getContents() const {
+    return {data, size};
+}
+
+std::vector<std::string_view> EpdReader::splitChunks(std::string_view text, size_t count) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t chunk = 1; chunk <= count && begin < text.size(); chunk++) {
+        auto end = text.size();
+        if (chunk < count) {
+            end = text.find('\n', std::max(begin, text.size() * chunk / count));
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+void EpdReader::forEachRecord(std::string_view text, const std::function<void(const EpdRecord &)> &visitor) {
+    size_t begin = 0;
+    while (begin < text.size()) {
+        auto end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        auto line = text.substr(begin, end - begin);
+        begin = end + 1;
+
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        visitor(EpdRecord::parse(line));
+    }
+}
+
+size_t EpdReader::forEachRecordParallel(size_t threadCount,
+                                        const std::function<void(const EpdRecord &, size_t chunk)> &visitor) const {
+    auto chunks = splitChunks(getContents(), std::max<size_t>(1, threadCount));
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::vector<std::thread> workers;
+    for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+        workers.emplace_back([&, chunk]() {
+            try {
+                forEachRecord(chunks[chunk], [&visitor, chunk](const EpdRecord &record) {
+                    visitor(record, chunk);
+                });
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    for (const auto &error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return chunks.size();
+}
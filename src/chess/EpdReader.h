@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_EPDREADER_H
+#define CHESS_EPDREADER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <functional>
+#include "CompactPosition.h"
+#include "FENParser.h"
+
+/**
+ * Single line of an EPD file - the position and the operations which follow it, eg. bm Nf3; id "WAC.001";
+ * All of the views point into the text the record was parsed from, nothing is copied.
+ */
+struct EpdRecord {
+    std::string_view line;
+    CompactPosition position;
+    std::string_view operations;
+    /**
+     * Set if the line does not start with a valid position, the offset is relative to the line
+     */
+    FenError error;
+
+    /**
+     * Parse the line, taking the halfmove clock and fullmove number from the hmvc and fmvn operations if present
+     */
+    static EpdRecord parse(std::string_view line);
+
+    /**
+     * Call the visitor with the opcode and operands of every operation in order. A single string operand
+     * is passed without its quotes.
+     */
+    void forEachOperation(const std::function<void(std::string_view opcode, std::string_view operands)> &visitor) const;
+
+    /**
+     * Operands of the first operation with the opcode, eg. "Nf3 Nc3" for bm, or an empty optional if there is none
+     */
+    std::optional<std::string_view> getOperation(std::string_view opcode) const;
+};
+
+/**
+ * Read-only view of an EPD or FEN file mapped into memory, one position per line. Empty lines and lines starting
+ * with # are skipped. The file is split at line boundaries into chunks which are parsed on separate threads.
+ */
+class EpdReader {
+private:
+    const char *data;
+    size_t size;
+
+public:
+    /**
+     * @throws EpdException if the file cannot be opened or mapped
+     */
+    explicit EpdReader(const std::string &path);
+
+    ~EpdReader();
+
+    EpdReader(const EpdReader &) = delete;
+
+    EpdReader &operator=(const EpdReader &) = delete;
+
+    std::string_view getContents() const;
+
+    /**
+     * Split the text into at most count chunks of similar size, each one ending at the end of a line
+     */
+    static std::vector<std::string_view> splitChunks(std::string_view text, size_t count);
+
+    /**
+     * Call the visitor for every record of the text in order
+     */
+    static void forEachRecord(std::string_view text, const std::function<void(const EpdRecord &)> &visitor);
+
+    /**
+     * Parse the file in chunks on the given number of threads. The visitor is called concurrently for different
+     * chunks, with the index of the chunk, so it can keep separate results for each of them without locking.
+     * Records of a single chunk are visited in order.
+     *
+     * @return number of chunks
+     */
+    size_t forEachRecordParallel(size_t threadCount,
+                                 const std::function<void(const EpdRecord &, size_t chunk)> &visitor) const;
+};
+
+
+#endif //CHESS_EPDREADER_H
@@ -5,230 +5,411 @@
  * Michał Łuszczek
  */
 
+#include <array>
+#include <utility>
 #include "FENParser.h"
+#include "PieceCode.h"
 #include "Game.h"
 #include "Board.h"
 #include "Color.h"
-#include "Player.h"
-#include "pieces/Pawn.h"
-#include "pieces/Rook.h"
-#include "pieces/Knight.h"
-#include "pieces/Bishop.h"
-#include "pieces/Queen.h"
-#include "pieces/King.h"
-
-Game FENParser::parseGame(const std::string &fen) {
-    auto elements = split(fen, ' ');
-
-    auto board = FENParser::parseBoard(elements[0]);
-
-    auto activePlayer = elements[1];
-    if (activePlayer.size() != 1 || (activePlayer[0] != 'w' && activePlayer[0] != 'b')) {
-        throw FenException("Invalid FEN representation of Game");
-    }
-    auto whitePlayer = new Player("Player One", Color::WHITE);
-    auto blackPlayer = new Player("Player Two", Color::BLACK);
-    auto currentPlayer = (activePlayer[0] == 'w') ? whitePlayer : blackPlayer;
-    for (auto piece: board->getAllPieces()) {
-        if (piece->getColor() == Color::WHITE) {
-            whitePlayer->getPieces().push_back(piece);
-        } else {
-            blackPlayer->getPieces().push_back(piece);
+#include "ChessExceptions.h"
+#include "constants.h"
+
+namespace {
+    /**
+     * Piece codes indexed by FEN piece characters, NO_PIECE for other characters
+     */
+    constexpr std::array<PieceCode, 128> generatePieceCodes() {
+        std::array<PieceCode, 128> codes{};
+        constexpr std::pair<char, PieceType> pieces[] = {{'p', PieceType::PAWN},
+                                                         {'r', PieceType::ROOK},
+                                                         {'n', PieceType::KNIGHT},
+                                                         {'b', PieceType::BISHOP},
+                                                         {'q', PieceType::QUEEN},
+                                                         {'k', PieceType::KING}};
+        for (const auto &piece: pieces) {
+            codes[piece.first] = makePieceCode(Color::BLACK, piece.second);
+            codes[piece.first - 'a' + 'A'] = makePieceCode(Color::WHITE, piece.second);
         }
+        return codes;
     }
 
-    auto castling = elements[2];
-    auto canWhiteKingsideCastle = castling.find('K') != -1;
-    auto canWhiteQueensideCastle = castling.find('Q') != -1;
-    auto canBlackKingsideCastle = castling.find('k') != -1;
-    auto canBlackQueensideCastle = castling.find('q') != -1;
+    constexpr std::array<PieceCode, 128> PIECE_CODES = generatePieceCodes();
 
-    auto enPassant = elements[3];
-    Position *enPassantPosition = nullptr;
-    if (!(enPassant.size() == 1 && enPassant[0] == '-') && enPassant.size() != 2) {
-        throw FenException("Invalid FEN representation of Game");
+    PieceCode pieceCodeOf(char character) {
+        return (static_cast<unsigned char>(character) < PIECE_CODES.size())
+               ? PIECE_CODES[static_cast<unsigned char>(character)]
+               : NO_PIECE;
     }
 
-    if (enPassant.size() == 2) {
-        auto pos = Position::fromString(enPassant);
-        enPassantPosition = new Position(pos.getRow(), pos.getCol());
-    }
+    /**
+     * Reads the fields of a FEN string one after another, keeping the offset for error reports
+     */
+    class FenReader {
+    private:
+        std::string_view fen;
+        size_t offset = 0;
 
-    int halfmoveClock;
-    try {
-        halfmoveClock = std::stoi(elements[4]);
-    } catch (std::exception &e) {
-        throw FenException("Invalid FEN - halfmove clock value");
-    }
+    public:
+        explicit FenReader(std::string_view fen) : fen(fen) {}
 
-    int fullmoveNumber;
-    try {
-        fullmoveNumber = std::stoi(elements[5]);
-    } catch (std::exception &e) {
-        throw FenException("Invalid FEN - fullmove number value");
-    }
+        FenError error(const char *message) const {
+            return {offset, message};
+        }
 
-    auto game = Game(
-            board,
-            whitePlayer,
-            blackPlayer,
-            currentPlayer,
-            canWhiteKingsideCastle,
-            canWhiteQueensideCastle,
-            canBlackKingsideCastle,
-            canBlackQueensideCastle,
-            enPassantPosition,
-            halfmoveClock,
-            fullmoveNumber
-    );
-    return game;
-}
+        bool atEnd() const {
+            return offset == fen.size();
+        }
 
-Board *FENParser::parseBoard(const std::string &fen) {
-    auto board = Board::emptyBoard();
-
-    int row = 8;
-    int col = 1;
-
-    for (auto character: fen) {
-        if (isdigit(character)) {
-            // empties
-            std::string stringOfEmpties = {character};
-            col += std::stoi(stringOfEmpties);
-
-        } else if (character == '/') {
-            // next row
-            row -= 1;
-            col = 1;
-        } else {
-            Piece *piece = nullptr;
-            switch (character) {
-                case 'p': {
-                    piece = new Pawn(Color::BLACK, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'P': {
-                    piece = new Pawn(Color::WHITE, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'r': {
-                    piece = new Rook(Color::BLACK, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'R': {
-                    piece = new Rook(Color::WHITE, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'n': {
-                    piece = new Knight(Color::BLACK, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'N': {
-                    piece = new Knight(Color::WHITE, board->getField(Position(row, col)));
-                    break;
-                }
-                case 'b': {
-                    piece = new Bishop(Color::BLACK, board->getField(Position(row, col)));
-                    break;
+        char peek() const {
+            return atEnd() ? '\0' : fen[offset];
+        }
+
+        char next() {
+            return atEnd() ? '\0' : fen[offset++];
+        }
+
+        /**
+         * Text which has not been read yet, without the leading spaces
+         */
+        std::string_view rest() {
+            while (peek() == ' ') {
+                offset++;
+            }
+            return fen.substr(offset);
+        }
+
+        /**
+         * Piece placement, 8 ranks of 8 fields from the 8th rank down
+         */
+        FenError readBoard(BoardSquares &squares) {
+            squares.fill(NO_PIECE);
+            int rank = BOARD_SIZE - 1;
+            int file = 0;
+            while (!atEnd() && peek() != ' ') {
+                auto character = peek();
+                if (character == '/') {
+                    if (file != BOARD_SIZE) {
+                        return error("expected 8 fields in a rank");
+                    }
+                    if (rank == 0) {
+                        return error("expected 8 ranks");
+                    }
+                    rank--;
+                    file = 0;
+                } else if (character >= '1' && character <= '8') {
+                    file += character - '0';
+                    if (file > BOARD_SIZE) {
+                        return error("too many fields in a rank");
+                    }
+                } else {
+                    auto code = pieceCodeOf(character);
+                    if (code == NO_PIECE) {
+                        return error("unknown piece");
+                    }
+                    if (file == BOARD_SIZE) {
+                        return error("too many fields in a rank");
+                    }
+                    if (pieceTypeOf(code) == PieceType::PAWN && (rank == 0 || rank == BOARD_SIZE - 1)) {
+                        return error("pawns cannot stand on the 1st or 8th rank");
+                    }
+                    squares[Square::at(rank, file).getIndex()] = code;
+                    file++;
                 }
-                case 'B': {
-                    piece = new Bishop(Color::WHITE, board->getField(Position(row, col)));
+                offset++;
+            }
+            if (rank != 0 || file != BOARD_SIZE) {
+                return error("expected 8 ranks of 8 fields");
+            }
+            return {};
+        }
+
+        FenError readSeparator() {
+            if (peek() != ' ') {
+                return error("expected a space");
+            }
+            offset++;
+            return {};
+        }
+
+        FenError readSideToMove(GameState &state) {
+            switch (peek()) {
+                case 'w':
+                    state.sideToMove = Color::WHITE;
                     break;
-                }
-                case 'q': {
-                    piece = new Queen(Color::BLACK, board->getField(Position(row, col)));
+                case 'b':
+                    state.sideToMove = Color::BLACK;
                     break;
+                default:
+                    return error("expected the side to move, w or b");
+            }
+            offset++;
+            return {};
+        }
+
+        /**
+         * Castling rights, each of which requires the king and the rook on their initial fields
+         */
+        FenError readCastling(GameState &state, const BoardSquares &squares) {
+            state.castlingRights = 0;
+            if (peek() == '-') {
+                offset++;
+                return {};
+            }
+            while (!atEnd() && peek() != ' ') {
+                uint8_t right;
+                switch (peek()) {
+                    case 'K':
+                        right = GameState::WHITE_KINGSIDE;
+                        break;
+                    case 'Q':
+                        right = GameState::WHITE_QUEENSIDE;
+                        break;
+                    case 'k':
+                        right = GameState::BLACK_KINGSIDE;
+                        break;
+                    case 'q':
+                        right = GameState::BLACK_QUEENSIDE;
+                        break;
+                    default:
+                        return error("expected castling rights, KQkq or -");
                 }
-                case 'Q': {
-                    piece = new Queen(Color::WHITE, board->getField(Position(row, col)));
-                    break;
+                if (state.castlingRights & right) {
+                    return error("repeated castling right");
                 }
-                case 'k': {
-                    piece = new King(Color::BLACK, board->getField(Position(row, col)));
-                    board->setBlackKing(piece);
-                    break;
+                if (!CompactPosition::hasCastlingPieces(squares, right)) {
+                    return error("castling right without the king and the rook on their initial fields");
                 }
-                case 'K': {
-                    piece = new King(Color::WHITE, board->getField(Position(row, col)));
-                    board->setWhiteKing(piece);
-                    break;
+                state.castlingRights |= right;
+                offset++;
+            }
+            if (state.castlingRights == 0) {
+                return error("expected castling rights, KQkq or -");
+            }
+            return {};
+        }
+
+        /**
+         * En passant target field, which requires the opponent's pawn which has just made a double step
+         * behind it and the fields it passed empty
+         */
+        FenError readEnPassant(GameState &state, const BoardSquares &squares) {
+            state.enPassantSquare = GameState::NO_EN_PASSANT;
+            if (peek() == '-') {
+                offset++;
+                return {};
+            }
+            auto start = offset;
+            auto file = peek() - 'a';
+            if (file < 0 || file >= BOARD_SIZE) {
+                return error("expected an en passant target field or -");
+            }
+            offset++;
+            auto target = Square::at(peek() - '1', file);
+            offset = start;
+            if (auto message = CompactPosition::checkEnPassant(squares, state.sideToMove, target)) {
+                return error(message);
+            }
+            offset += 2;
+            state.enPassantSquare = static_cast<int8_t>(target.getIndex());
+            return {};
+        }
+
+        FenError readNumber(uint16_t &number, const char *message) {
+            uint32_t value = 0;
+            auto start = offset;
+            while (peek() >= '0' && peek() <= '9') {
+                value = value * 10 + (next() - '0');
+                if (value > UINT16_MAX) {
+                    offset = start;
+                    return error(message);
                 }
-                default:
-                    throw FenException("Invalid FEN representation of Game");
             }
-            board->getAllPieces().push_back(piece);
-            board->getField(Position(row, col))->setPiece(piece);
-            col += 1;
+            if (offset == start) {
+                return error(message);
+            }
+            number = static_cast<uint16_t>(value);
+            return {};
         }
+    };
+}
+
+FenError FENParser::parsePosition(std::string_view fen, CompactPosition &position) {
+    FenReader reader(fen);
+    FenError error{};
+    if ((error = reader.readBoard(position.squares)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readSideToMove(position.state)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readCastling(position.state, position.squares)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readEnPassant(position.state, position.squares)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readNumber(position.state.halfmoveClock, "expected the halfmove clock")) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readNumber(position.state.fullmoveNumber, "expected the fullmove number"))) {
+        return error;
+    }
+    if (!reader.atEnd()) {
+        return reader.error("unexpected characters after the fullmove number");
     }
-    return board;
+    return {0, CompactPosition::checkKings(position.squares)};
 }
 
-std::string FENParser::gameToString(const Game &game) {
-    std::stringstream ss;
-    auto board = FENParser::boardToString(*game.getBoard());
-    auto activePlayer = (game.getCurrentPlayer() == game.getWhitePlayer()) ? "w" : "b";
-    auto castling = FENParser::castlingAvailability(game);
-    auto enPassant = (game.getEnPassantTargetPosition() != nullptr)
-                     ? game.getEnPassantTargetPosition()->toString()
-                     : "-";
-
-    ss << board << " "
-       << activePlayer << " "
-       << castling << " "
-       << enPassant << " "
-       << game.getHalfmoveClock() << " "
-       << game.getFullmoveNumber();
-
-    return ss.str();
+FenError FENParser::parseEpd(std::string_view epd, CompactPosition &position, std::string_view &operations) {
+    FenReader reader(epd);
+    FenError error{};
+    position.state.halfmoveClock = 0;
+    position.state.fullmoveNumber = 1;
+    if ((error = reader.readBoard(position.squares)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readSideToMove(position.state)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readCastling(position.state, position.squares)) ||
+        (error = reader.readSeparator()) ||
+        (error = reader.readEnPassant(position.state, position.squares))) {
+        return error;
+    }
+
+    // FEN corpora keep the clocks after the en passant field, while EPD operations always start with an opcode
+    if (!reader.atEnd() && (error = reader.readSeparator())) {
+        return error;
+    }
+    if (reader.peek() >= '0' && reader.peek() <= '9') {
+        if ((error = reader.readNumber(position.state.halfmoveClock, "expected the halfmove clock")) ||
+            (error = reader.readSeparator()) ||
+            (error = reader.readNumber(position.state.fullmoveNumber, "expected the fullmove number"))) {
+            return error;
+        }
+        if (!reader.atEnd() && reader.peek() != ' ') {
+            return reader.error("expected a space");
+        }
+    }
+    operations = reader.rest();
+    return {0, CompactPosition::checkKings(position.squares)};
 }
 
-std::string FENParser::boardToString(const Board &board) {
-    std::stringstream ss;
+Game FENParser::parseGame(std::string_view fen) {
+    CompactPosition position{};
+    auto error = parsePosition(fen, position);
+    if (error) {
+        throw FenException(error.message, error.offset);
+    }
+    return Game(position);
+}
 
-    for (int row = BOARD_SIZE; row >= 1; row--) {
-        for (int col = 1; col <= BOARD_SIZE; col++) {
-            int empties = 0;
-            auto tempCol = col;
-            while (tempCol <= BOARD_SIZE && board.getField(Position(row, tempCol))->isEmpty()) {
-                empties++;
-                tempCol++;
+Board *FENParser::parseBoard(std::string_view fen) {
+    BoardSquares squares{};
+    FenReader reader(fen);
+    auto error = reader.readBoard(squares);
+    if (!error && !reader.atEnd()) {
+        error = reader.error("unexpected characters after the board");
+    }
+    if (error) {
+        throw FenException(error.message, error.offset);
+    }
+    return Board::fromSquares(squares);
+}
+
+namespace {
+    // piece characters indexed by piece codes, white pieces in upper case
+    constexpr char PIECE_CHARACTERS[] = " PRBNKQ  prbnkq";
+
+    static_assert(PIECE_CHARACTERS[makePieceCode(Color::BLACK, PieceType::QUEEN)] == 'q',
+                  "piece characters follow the piece codes");
+
+    char *writeBoard(const BoardSquares &squares, char *output) {
+        for (int rank = BOARD_SIZE - 1; rank >= 0; rank--) {
+            char empties = 0;
+            for (int file = 0; file < BOARD_SIZE; file++) {
+                auto code = squares[Square::at(rank, file).getIndex()];
+                if (code == NO_PIECE) {
+                    empties++;
+                    continue;
+                }
+                if (empties > 0) {
+                    *output++ = static_cast<char>('0' + empties);
+                    empties = 0;
+                }
+                *output++ = PIECE_CHARACTERS[code];
+            }
+            if (empties > 0) {
+                *output++ = static_cast<char>('0' + empties);
             }
-            if (empties == 0) {
-                auto currPieceChar = board.getField(Position(row, col))->getPiece()->getCharacter();
-                ss << currPieceChar;
-            } else {
-                ss << empties;
-                col = col + empties - 1;
+            if (rank > 0) {
+                *output++ = '/';
             }
         }
-        ss << '/';
+        return output;
     }
 
-    std::string result = ss.str();
-    result = result.substr(0, result.size() - 1);
-    return result;
+    char *writeNumber(uint16_t number, char *output) {
+        char digits[5];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number > 0);
+        while (count > 0) {
+            *output++ = digits[--count];
+        }
+        return output;
+    }
 }
 
-std::string FENParser::castlingAvailability(const Game &game) {
-    std::stringstream ss;
-    if (game.getCanWhiteKingsideCastle()) {
-        ss << "K";
-    }
-    if (game.getCanWhiteQueensideCastle()) {
-        ss << "Q";
-    }
-    if (game.getCanBlackKingsideCastle()) {
-        ss << "k";
+size_t FENParser::writePosition(const CompactPosition &position, FenBuffer &buffer) {
+    const auto &state = position.state;
+    auto output = writeBoard(position.squares, buffer);
+
+    *output++ = ' ';
+    *output++ = (state.sideToMove == Color::WHITE) ? 'w' : 'b';
+
+    *output++ = ' ';
+    if (state.castlingRights == 0) {
+        *output++ = '-';
     }
-    if (game.getCanBlackQueensideCastle()) {
-        ss << "q";
+    for (auto right: {std::make_pair(GameState::WHITE_KINGSIDE, 'K'), std::make_pair(GameState::WHITE_QUEENSIDE, 'Q'),
+                      std::make_pair(GameState::BLACK_KINGSIDE, 'k'), std::make_pair(GameState::BLACK_QUEENSIDE, 'q')}) {
+        if (state.hasCastlingRight(right.first)) {
+            *output++ = right.second;
+        }
     }
 
-    auto result = ss.str();
-    if (result.empty()) {
-        return "-";
+    *output++ = ' ';
+    auto enPassant = state.getEnPassantSquare();
+    if (enPassant.isValid()) {
+        *output++ = static_cast<char>('a' + enPassant.getFile());
+        *output++ = static_cast<char>('1' + enPassant.getRank());
+    } else {
+        *output++ = '-';
     }
 
-    return result;
+    *output++ = ' ';
+    output = writeNumber(state.halfmoveClock, output);
+    *output++ = ' ';
+    output = writeNumber(state.fullmoveNumber, output);
+    *output = '\0';
+    return output - buffer;
+}
+
+size_t FENParser::writeGame(const Game &game, FenBuffer &buffer) {
+    return writePosition({game.getBoard()->getSquares(), game.getGameState()}, buffer);
+}
+
+void FENParser::appendGame(const Game &game, std::string &output) {
+    FenBuffer buffer;
+    auto length = writeGame(game, buffer);
+    output.append(buffer, length);
+}
+
+std::string FENParser::gameToString(const Game &game) {
+    FenBuffer buffer;
+    auto length = writeGame(game, buffer);
+    return {buffer, length};
+}
+
+std::string FENParser::boardToString(const Board &board) {
+    FenBuffer buffer;
+    auto end = writeBoard(board.getSquares(), buffer);
+    return {buffer, end};
 }
@@ -8,27 +8,84 @@
 #ifndef CHESS_FENPARSER_H
 #define CHESS_FENPARSER_H
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include "CompactPosition.h"
 
 class Game;
 class Board;
 
+/**
+ * Result of parsing a FEN string, empty on success
+ */
+struct FenError {
+    /**
+     * Index of the character at which the error was found
+     */
+    size_t offset;
+    const char *message;
+
+    explicit operator bool() const {
+        return message != nullptr;
+    }
+};
+
 /**
  * Handle parsing from and exporting to Forsyth–Edwards Notation
  * https://en.wikipedia.org/wiki/Forsyth%E2%80%93Edwards_Notation
  */
 class FENParser {
-private:
-    static std::string castlingAvailability(const Game &game);
-
 public:
-    static Game parseGame(const std::string &fen);
+    /**
+     * Longest FEN string of a position - 71 characters of the board, 4 of castling rights, 2 of the en passant
+     * target, two clocks of up to 5 digits and 5 separators
+     */
+    static constexpr size_t MAX_FEN_LENGTH = 93;
+
+    /**
+     * Buffer holding any FEN string with its terminating null character
+     */
+    using FenBuffer = char[MAX_FEN_LENGTH + 1];
+
+    /**
+     * Parse a complete FEN string into the position without allocating memory or throwing
+     */
+    static FenError parsePosition(std::string_view fen, CompactPosition &position);
+
+    /**
+     * Parse the four position fields of an Extended Position Description record, optionally followed by the two
+     * clocks as in FEN, without allocating memory or throwing. The clocks are set to 0 and 1 if they are missing.
+     * https://www.chessprogramming.org/Extended_Position_Description
+     *
+     * @param operations set to the text after the position, eg. bm Nf3; id "WAC.001";
+     */
+    static FenError parseEpd(std::string_view epd, CompactPosition &position, std::string_view &operations);
+
+    /**
+     * @throws FenException with the offset of the error if the FEN string is invalid
+     */
+    static Game parseGame(std::string_view fen);
 
     /**
      * Creates a board object based on the given the FEN board description (without additional info, like castling
      * rights)
      */
-    static Board *parseBoard(const std::string &fen);
+    static Board *parseBoard(std::string_view fen);
+
+    /**
+     * Write the FEN string of the position into the buffer in a single pass, terminated with a null character
+     *
+     * @return number of characters written, without the null character
+     */
+    static size_t writePosition(const CompactPosition &position, FenBuffer &buffer);
+
+    static size_t writeGame(const Game &game, FenBuffer &buffer);
+
+    /**
+     * Append the FEN string of the game to the output, without allocating if it has enough capacity
+     */
+    static void appendGame(const Game &game, std::string &output);
 
     static std::string gameToString(const Game &game);
 
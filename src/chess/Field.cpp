@@ -6,6 +6,7 @@
  */
 
 #include "Field.h"
+#include "Board.h"
 
 Piece *Field::getPiece() const {
     return piece;
@@ -24,5 +25,12 @@ Board *Field::getBoard() const {
 }
 
 void Field::setPiece(Piece *newPiece) {
+    if (parentBoard != nullptr) {
+        parentBoard->updateField(piece, newPiece, position);
+    }
+    this->piece = newPiece;
+}
+
+void Field::attachPiece(Piece *newPiece) {
     this->piece = newPiece;
 }
@@ -12,7 +12,6 @@
 #include <memory>
 #include "pieces/Piece.h"
 #include "Position.h"
-#include "Board.h"
 
 class Board;
 class Piece;
@@ -37,6 +36,12 @@ public:
 
     void setPiece(Piece *newPiece);
 
+    /**
+     * Put the piece on the field without updating the piece codes and counters of the board, for a board which
+     * copies them from another one
+     */
+    void attachPiece(Piece *newPiece);
+
     Board *getBoard() const;
 
     bool isEmpty() const;
@@ -5,8 +5,9 @@
  * Michał Łuszczek
  */
 
-#include <map>
 #include <algorithm>
+#include <array>
+#include <utility>
 #include "Game.h"
 #include "Board.h"
 #include "Color.h"
@@ -16,26 +17,19 @@
 #include "pieces/Pawn.h"
 #include "pieces/PieceType.h"
 #include "GameOver.h"
-#include "FENParser.h"
 #include "HistoryManager.h"
+#include "Zobrist.h"
+#include "MoveGenerator.h"
+#include "MoveCache.h"
 
 
 Game::Game(std::string whiteName, std::string blackName) {
     this->board = Board::startingBoard();
     this->whitePlayer = new Player(whiteName, Color::WHITE);
     this->blackPlayer = new Player(blackName, Color::BLACK);
-    this->gameState.currentPlayer = whitePlayer;
+    this->gameState = GameState::initial();
     this->history = new HistoryManager();
 
-    this->gameState.canWhiteKingsideCastle = true;
-    this->gameState.canWhiteQueensideCastle = true;
-    this->gameState.canBlackKingsideCastle = true;
-    this->gameState.canBlackQueensideCastle = true;
-    this->gameState.enPassantTargetPosition = nullptr;
-    this->gameState.halfmoveClock = 0;
-    this->gameState.fullmoveNumber = 1;
-    this->positionCount = {{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", 1}};
-
     for (Piece *piece: board->getAllPieces()) {
         if (piece->getColor() == Color::WHITE) {
             whitePlayer->getPieces().push_back(piece);
@@ -43,6 +37,70 @@ Game::Game(std::string whiteName, std::string blackName) {
             blackPlayer->getPieces().push_back(piece);
         }
     }
+    this->positionHash = Zobrist::hash(*this);
+}
+
+Game::Game(const Game &other) :
+        board(new Board(*other.board)),
+        whitePlayer(new Player(other.whitePlayer->getName(), Color::WHITE)),
+        blackPlayer(new Player(other.blackPlayer->getName(), Color::BLACK)),
+        gameState(other.gameState),
+        positionHash(other.positionHash),
+        terminalStatus(other.terminalStatus.load(std::memory_order_relaxed)),
+        history(new HistoryManager(*other.history)),
+        moveCache(other.moveCache) {
+    // the players' pieces in the same order as the other game's, so that the moves are generated in the same order
+    for (auto [player, otherPlayer]: {std::make_pair(whitePlayer, other.whitePlayer),
+                                      std::make_pair(blackPlayer, other.blackPlayer)}) {
+        auto &pieces = player->getPieces();
+        pieces.reserve(otherPlayer->getPieces().size());
+        for (auto piece: otherPlayer->getPieces()) {
+            pieces.push_back(board->getField(piece->getPosition())->getPiece());
+        }
+    }
+    auto enPassantTarget = getEnPassantTargetPiece();
+    if (enPassantTarget != nullptr) {
+        enPassantTarget->setIsEnPassantTarget(true);
+    }
+}
+
+Game::Game(Game &&other) noexcept:
+        board(other.board),
+        whitePlayer(other.whitePlayer),
+        blackPlayer(other.blackPlayer),
+        gameState(other.gameState),
+        positionHash(other.positionHash),
+        terminalStatus(other.terminalStatus.load(std::memory_order_relaxed)),
+        history(other.history),
+        moveCache(other.moveCache) {
+    other.board = nullptr;
+    other.whitePlayer = nullptr;
+    other.blackPlayer = nullptr;
+    other.history = nullptr;
+}
+
+Game &Game::operator=(const Game &other) {
+    if (this != &other) {
+        Game copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+Game &Game::operator=(Game &&other) noexcept {
+    swap(other);
+    return *this;
+}
+
+void Game::swap(Game &other) noexcept {
+    std::swap(board, other.board);
+    std::swap(whitePlayer, other.whitePlayer);
+    std::swap(blackPlayer, other.blackPlayer);
+    std::swap(gameState, other.gameState);
+    std::swap(positionHash, other.positionHash);
+    terminalStatus = other.terminalStatus.exchange(terminalStatus, std::memory_order_relaxed);
+    std::swap(history, other.history);
+    std::swap(moveCache, other.moveCache);
 }
 
 Game::~Game() {
@@ -57,15 +115,23 @@ Board *Game::getBoard() const {
 }
 
 Player *Game::getCurrentPlayer() {
-    return gameState.currentPlayer;
+    return (gameState.sideToMove == Color::WHITE) ? whitePlayer : blackPlayer;
 }
 
 bool Game::isMate() const {
-    return (isCheck(gameState.currentPlayer->getColor()) && getLegalMovesForPlayer(gameState.currentPlayer).empty());
+    return getTerminalStatus().result == GameOver::MATE;
 }
 
 bool Game::isStalemate() const {
-    return (!isCheck(gameState.currentPlayer->getColor()) && getLegalMovesForPlayer(gameState.currentPlayer).empty());
+    return getTerminalStatus().result == GameOver::STALEMATE;
+}
+
+bool Game::isCurrentPlayerInCheck() const {
+    return getTerminalStatus().check;
+}
+
+size_t Game::getLegalMoveCount() const {
+    return getTerminalStatus().legalMoveCount;
 }
 
 void Game::makeMove(const Move &move, bool updateHistory) {
@@ -74,21 +140,51 @@ void Game::makeMove(const Move &move, bool updateHistory) {
     }
 
     if (updateHistory) {
-        history->update(move, gameState);
+        history->update(move, gameState, positionHash);
+    }
+
+    // fields whose pieces change - a castling king and rook stay on their rank, an en passant capture removes
+    // the pawn next to the source field
+    std::array<int, BOARD_SIZE> changedSquares{};
+    size_t changedCount = 0;
+    auto from = move.getFromSquare();
+    auto to = move.getToSquare();
+    if (move.isCastling()) {
+        for (int file = 0; file < BOARD_SIZE; file++) {
+            changedSquares[changedCount++] = Square::at(from.getRank(), file).getIndex();
+        }
+    } else {
+        changedSquares[changedCount++] = from.getIndex();
+        changedSquares[changedCount++] = to.getIndex();
+        if (move.isCapture() && board->getSquares()[to.getIndex()] == NO_PIECE) {
+            changedSquares[changedCount++] = Square::at(from.getRank(), to.getFile()).getIndex();
+        }
     }
+    auto updateHash = [this, &changedSquares, changedCount]() {
+        const auto &squares = board->getSquares();
+        positionHash ^= Zobrist::stateKey(squares, gameState);
+        for (size_t i = 0; i < changedCount; i++) {
+            positionHash ^= Zobrist::squareKey(squares, changedSquares[i]);
+        }
+    };
+    updateHash();
 
-    gameState.update(move, this->getEnPassantTargetPiece());
+    auto oldEnPassantTarget = this->getEnPassantTargetPiece();
+    if (oldEnPassantTarget != nullptr) {
+        oldEnPassantTarget->setIsEnPassantTarget(false);
+    }
+    gameState.update(move);
 
     this->board->makeMove(move);
     if (move.getPromoteTo() != PieceType::NONE) {
-        gameState.currentPlayer->removePiece(move.getPiece());
-        gameState.currentPlayer->getPieces().push_back(getPiece(move.getTo()));
+        getCurrentPlayer()->removePiece(move.getPiece());
+        getCurrentPlayer()->getPieces().push_back(getPiece(move.getTo()));
     }
     if (move.isDoublePawnMove()) {
-        auto row = (move.getFrom().getRow() + move.getTo().getRow()) / 2;
-        auto col = move.getTo().getCol();
-        this->gameState.enPassantTargetPosition = new Position(row, col);
-        auto movedPawn = dynamic_cast<Pawn *>(move.getPiece());
+        auto passedSquare = Square::at((move.getFromSquare().getRank() + move.getToSquare().getRank()) / 2,
+                                       move.getToSquare().getFile());
+        this->gameState.enPassantSquare = static_cast<int8_t>(passedSquare.getIndex());
+        auto movedPawn = static_cast<Pawn *>(move.getPiece());
         movedPawn->setIsEnPassantTarget(true);
     }
 
@@ -98,10 +194,8 @@ void Game::makeMove(const Move &move, bool updateHistory) {
         player->removePiece(captured);
     }
 
-    auto fenOfCurrentBoard = FENParser::boardToString(*(this->board)); // todo: what about this?
-    positionCount[fenOfCurrentBoard] = (positionCount.find(fenOfCurrentBoard) == positionCount.end()) ? 1 :
-                                       positionCount[fenOfCurrentBoard] + 1;
     this->switchCurrentPlayer();
+    updateHash();
 }
 
 Player *Game::getWhitePlayer() const {
@@ -117,32 +211,26 @@ Piece *Game::getPiece(Position position) const {
     return this->getBoard()->getField(position)->getPiece();
 }
 
-Game::Game(
-        Board *board,
-        Player *whitePlayer,
-        Player *blackPlayer,
-        Player *currentPlayer,
-        bool canWhiteKingsideCastle,
-        bool canWhiteQueensideCastle,
-        bool canBlackKingsideCastle,
-        bool canBlackQueensideCastle,
-        Position *enPassantTarget,
-        int halfmoveClock,
-        int fullmoveNumber
-) :
+Game::Game(Board *board, Player *whitePlayer, Player *blackPlayer, const GameState &gameState) :
         board(board),
         whitePlayer(whitePlayer),
         blackPlayer(blackPlayer),
-        positionCount({}) {
-    this->gameState.canWhiteKingsideCastle = canWhiteKingsideCastle;
-    this->gameState.canWhiteQueensideCastle = canWhiteQueensideCastle;
-    this->gameState.canBlackKingsideCastle = canBlackKingsideCastle;
-    this->gameState.canBlackQueensideCastle = canBlackQueensideCastle;
-    this->gameState.enPassantTargetPosition = enPassantTarget;
-    this->gameState.halfmoveClock = halfmoveClock;
-    this->gameState.fullmoveNumber = fullmoveNumber;
-    this->gameState.currentPlayer = currentPlayer;
+        gameState(gameState) {
     this->history = new HistoryManager();
+    this->positionHash = Zobrist::hash(*this);
+}
+
+Game::Game(const CompactPosition &position) :
+        board(Board::fromSquares(position.squares)),
+        whitePlayer(new Player("Player One", Color::WHITE)),
+        blackPlayer(new Player("Player Two", Color::BLACK)),
+        gameState(position.state) {
+    for (auto piece: board->getAllPieces()) {
+        auto player = (piece->getColor() == Color::WHITE) ? whitePlayer : blackPlayer;
+        player->getPieces().push_back(piece);
+    }
+    this->history = new HistoryManager();
+    this->positionHash = Zobrist::hash(*this);
 }
 
 std::vector<Move> Game::getMovesFrom(Position position) const {
@@ -150,14 +238,10 @@ std::vector<Move> Game::getMovesFrom(Position position) const {
     if (piece == nullptr)
         return {};
 
-    auto movesForPiece = piece->getMoves();
-    if (piece->getType() == PieceType::KING) {
-        if (possibleKingsideCastlingThisRound()) {
-            movesForPiece.push_back(generateKingSideCastle());
-        }
-        if (possibleQueensideCastlingThisRound()) {
-            movesForPiece.push_back(generateQueenSideCastle());
-        }
+    std::vector<Move> movesForPiece;
+    MoveGenerator::generatePieceMoves(*board, position.toSquare(), gameState.getEnPassantSquare(), movesForPiece);
+    if (piece->getType() == PieceType::KING && piece->getColor() == gameState.sideToMove) {
+        MoveGenerator::generateCastlingMoves(*board, gameState, movesForPiece);
     }
     return movesForPiece;
 }
@@ -173,247 +257,210 @@ std::vector<Move> Game::getAllMovesForPlayer(Player *player) const {
 
 std::vector<Move> Game::getLegalMovesFrom(Position position) const {
     auto piece = this->getPiece(position);
-    if (piece == nullptr || piece->getColor() != gameState.currentPlayer->getColor())
+    if (piece == nullptr || piece->getColor() != gameState.sideToMove)
         return {};
 
-    auto pieceColor = piece->getColor();
-    auto movesForPiece = getMovesFrom(position);
-    movesForPiece.erase(
-            std::remove_if(movesForPiece.begin(), movesForPiece.end(), [pieceColor, this](Move m) {
-                auto deepCopy = this->afterMove(m);
-                return deepCopy.isCheck(pieceColor);
-            }),
-            movesForPiece.end());
-
-    if (piece->getType() == PieceType::KING) {
-        // remove moves which are impossible to perform due to opponent's pieces controlling the square between
-        // king and rook
-        movesForPiece.erase(std::remove_if(movesForPiece.begin(), movesForPiece.end(),
-                                           [this](Move &move) {
-                                               return this->isCastlingObscuredByOpponent(move) && move.isCastling();
-                                           }),
-                            movesForPiece.end());
+    if (moveCache != nullptr) {
+        std::vector<Move> moves;
+        moveCache->getLegalMoves(*this, moves);
+        auto from = position.toSquare();
+        moves.erase(std::remove_if(moves.begin(), moves.end(), [from](const Move &move) {
+            return move.getFromSquare() != from;
+        }), moves.end());
+        return moves;
     }
+
+    auto movesForPiece = getMovesFrom(position);
+    movesForPiece.erase(std::remove_if(movesForPiece.begin(), movesForPiece.end(), [this](const Move &move) {
+        return !MoveGenerator::isLegal(*board, gameState, move);
+    }), movesForPiece.end());
     return movesForPiece;
 }
 
-std::vector<Move> Game::getLegalMovesForPlayer(Player *player) const {
-    std::vector<Move> moves = {};
-    for (auto piece: player->getPieces()) {
-        auto pieceMoves = getLegalMovesFrom(piece->getPosition());
-        moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
+bool Game::isLegal(const Move &move) const {
+    if (!MoveGenerator::isPseudoLegal(*board, gameState, move)) {
+        return false;
     }
-    return moves;
-}
-
-Pawn *Game::getEnPassantTargetPiece() const {
-    if (gameState.enPassantTargetPosition == nullptr)
-        return nullptr;
-
-    int targetRow = gameState.enPassantTargetPosition->getRow();
-    int targetCol = gameState.enPassantTargetPosition->getCol();
-    int rowOffsetFromEPPosition = (gameState.currentPlayer == whitePlayer) ? -1 : 1;
-
-    auto positionOfTargetPiece = Position(targetRow + rowOffsetFromEPPosition, targetCol);
-    auto ePTargetPiece = dynamic_cast<Pawn *>(getPiece(positionOfTargetPiece));
-    if (ePTargetPiece == nullptr)
-        throw std::bad_cast();
-    return ePTargetPiece;
-}
-
-
-bool Game::possibleKingsideCastlingThisRound() const {
-    if (getCurrentPlayer()->getColor() == Color::WHITE && !gameState.canWhiteKingsideCastle ||
-        getCurrentPlayer()->getColor() == Color::BLACK && !gameState.canBlackKingsideCastle) {
+    // the generated moves leave the promotion piece to be chosen, a played one must have it
+    if (move.getPromoteTo() == PieceType::NONE && move.resultsInPromotion()) {
         return false;
     }
-    int currentPlayerBackRank = (getCurrentPlayer()->getColor() == Color::WHITE) ? 1 : 8;
-    auto kingSideRook = getPiece(Position(currentPlayerBackRank, 8));
-    auto king = getPiece(Position(currentPlayerBackRank, 5));
-
-    bool canCastle = (noPiecesBetweenKingAndRook(king, kingSideRook));
-    return canCastle;
+    return MoveGenerator::isLegal(*board, gameState, move);
 }
 
-bool Game::possibleQueensideCastlingThisRound() const {
-    if (getCurrentPlayer()->getColor() == Color::WHITE && !gameState.canWhiteQueensideCastle ||
-        getCurrentPlayer()->getColor() == Color::BLACK && !gameState.canBlackQueensideCastle) {
-        return false;
-    }
-    int currentPlayerBackRank = (getCurrentPlayer()->getColor() == Color::WHITE) ? 1 : 8;
-    auto queenSideRook = getPiece(Position(currentPlayerBackRank, 1));
-    auto king = getPiece(Position(currentPlayerBackRank, 5));
+std::vector<Move> Game::getLegalMovesForPlayer(Player *player) const {
+    if (player->getColor() != gameState.sideToMove)
+        return {};
 
-    bool canCastle = (noPiecesBetweenKingAndRook(king, queenSideRook));
-    return canCastle;
+    std::vector<Move> moves;
+    getLegalMoves(moves);
+    return moves;
 }
 
-bool Game::noPiecesBetweenKingAndRook(const Piece *king, const Piece *rook) const {
-    if (king->getPosition().getRow() != rook->getPosition().getRow())
-        throw std::invalid_argument("King and rook can't be in different rows!");
+void Game::getLegalMoves(std::vector<Move> &moves) const {
+    if (moveCache != nullptr) {
+        moveCache->getLegalMoves(*this, moves);
+    } else {
+        moves.clear();
+        MoveGenerator::generateLegalMoves(*board, gameState, moves);
+    }
+}
 
-    auto row = king->getPosition().getRow();
-    auto lowestColToCheck = std::min(king->getPosition().getCol(), rook->getPosition().getCol()) + 1;
-    auto upperLimit = std::max(king->getPosition().getCol(), rook->getPosition().getCol());
+size_t Game::perft(int depth) {
+    static constexpr PieceType PROMOTIONS[] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP,
+                                               PieceType::KNIGHT};
+    if (depth == 0)
+        return 1;
 
-    for (int currentCol = lowestColToCheck; currentCol < upperLimit; currentCol++) {
-        auto currentPosition = Position(row, currentCol);
-        if (getPiece(currentPosition) != nullptr)
-            return false;
+    std::vector<Move> moves;
+    MoveGenerator::generateLegalMoves(*board, gameState, moves);
+    auto countAfter = [this, depth](const Move &move) -> size_t {
+        if (depth == 1)
+            return 1;
+        makeMove(move);
+        auto nodes = perft(depth - 1);
+        undoMove();
+        return nodes;
+    };
+
+    size_t nodes = 0;
+    for (auto &move: moves) {
+        if (!move.resultsInPromotion()) {
+            nodes += countAfter(move);
+            continue;
+        }
+        for (auto promotion: PROMOTIONS) {
+            move.setPromotion(promotion);
+            nodes += countAfter(move);
+        }
     }
-    return true;
+    return nodes;
 }
 
-Move Game::generateKingSideCastle() const {
-    int castlingRank = (gameState.currentPlayer->getColor() == Color::WHITE) ? 1 : 8;
-    auto fromPosition = Position(castlingRank, 5);
-    auto toPosition = Position(castlingRank, 7);
-    return Move(fromPosition, toPosition, getPiece(fromPosition), nullptr);
-}
+Pawn *Game::getEnPassantTargetPiece() const {
+    auto enPassantTarget = gameState.getEnPassantSquare();
+    if (!enPassantTarget.isValid())
+        return nullptr;
 
-Move Game::generateQueenSideCastle() const {
-    int castlingRank = (gameState.currentPlayer->getColor() == Color::WHITE) ? 1 : 8;
-    auto fromPosition = Position(castlingRank, 5);
-    auto toPosition = Position(castlingRank, 3);
-    return Move(fromPosition, toPosition, getPiece(fromPosition), nullptr);
+    int rankOffsetFromEPPosition = (gameState.sideToMove == Color::WHITE) ? -1 : 1;
+    auto targetPieceSquare = enPassantTarget.offset(rankOffsetFromEPPosition, 0);
+    auto ePTargetPiece = targetPieceSquare.isValid() ? board->getPiece(targetPieceSquare) : nullptr;
+    if (ePTargetPiece == nullptr || ePTargetPiece->getType() != PieceType::PAWN ||
+        ePTargetPiece->getColor() == gameState.sideToMove)
+        return nullptr;
+    return static_cast<Pawn *>(ePTargetPiece);
 }
 
+
 bool Game::isFieldControlledByPlayer(const Position &pos, Color colorOfPlayer) const {
-    Player *playerThatCouldControlTheField = (colorOfPlayer == Color::WHITE) ? whitePlayer : blackPlayer;
-    auto movesForControllingPlayer = getAllMovesForPlayer(playerThatCouldControlTheField);
-    auto controlsByNonPawns = std::any_of(movesForControllingPlayer.begin(),
-                                          movesForControllingPlayer.end(),
-                                          [pos](const Move &m) {
-                                              // pawns control different fields than the ones they can move to if they can't capture
-                                              return m.getTo() == pos && m.getPiece()->getType() != PieceType::PAWN;
-                                          });
-
-    // iterate through all pawns, cast them to pawns and if they are one, check whether any of the controlled
-    // fields matches the one we're comparing with
-    auto controlsByPawns = std::any_of(playerThatCouldControlTheField->getPieces().begin(),
-                                       playerThatCouldControlTheField->getPieces().end(),
-                                       [pos](Piece *piece) {
-                                           auto castToPawn = dynamic_cast<Pawn *>(piece);
-                                           if (castToPawn != nullptr) {
-                                               auto positionsControlled = castToPawn->attackedPositions();
-                                               return std::any_of(
-                                                       positionsControlled.begin(),
-                                                       positionsControlled.end(),
-                                                       [pos](Position attackedPos) { return pos == attackedPos; });
-                                           } else return false;
-                                       });
-    return controlsByNonPawns || controlsByPawns;
+    return MoveGenerator::isSquareAttacked(board->getSquares(), board->getOccupied(), pos.toSquare(), colorOfPlayer);
 }
 
 
 bool Game::isCheck(Color colorOfCheckedKing) const {
-    auto possiblyCheckedKing = (colorOfCheckedKing == Color::WHITE) ? board->getWhiteKing() : board->getBlackKing();
-    Player *possiblyCheckingPlayer = (colorOfCheckedKing == Color::WHITE) ? blackPlayer : whitePlayer;
-    auto movesForCheckingPlayer = getAllMovesForPlayer(possiblyCheckingPlayer);
-    if (std::any_of(movesForCheckingPlayer.begin(),
-                    movesForCheckingPlayer.end(),
-                    [possiblyCheckedKing](const Move &m) {
-                        return m.getCapturedPiece() == possiblyCheckedKing;
-                    }))
-        return true;
-    return false;
+    return MoveGenerator::isKingAttacked(board->getSquares(), board->getOccupied(), colorOfCheckedKing);
 }
 
 Game Game::afterMove(const Move &move) const {
-    auto copy = this->deepCopy();
+    Game copy(*this);
     auto sourcePiece = copy.getPiece(move.getFrom());
 
     Piece *takenPiece = (move.getCapturedPiece() == nullptr)
                         ? nullptr
                         : copy.getPiece(move.getCapturedPiece()->getPosition());
-    auto moveEquivalentForDeepCopy = Move(move.getFrom(), move.getTo(), sourcePiece, takenPiece);
+    auto moveEquivalentForDeepCopy = Move(move.getFrom(), move.getTo(), sourcePiece, takenPiece,
+                                          move.getPromoteTo());
     copy.makeMove(moveEquivalentForDeepCopy);
     return copy;
 }
 
-bool Game::isCastlingObscuredByOpponent(Move &move) const {
-    if (isCheck(move.getPiece()->getColor()))
-        return true;
+GameOver Game::isOver() const {
+    return getTerminalStatus().result;
+}
 
-    auto row = move.getTo().getRow();
-    auto lowestColToCheck = std::min(move.getTo().getCol(), move.getFrom().getCol()) + 1;
-    auto upperLimit = std::max(move.getTo().getCol(), move.getFrom().getCol());
-    auto opponentColor = (move.getPiece()->getColor() == Color::WHITE) ? Color::BLACK : Color::WHITE;
-    for (auto col = lowestColToCheck; col < upperLimit; col++) {
-        if (isFieldControlledByPlayer(Position(row, col), opponentColor))
-            return true;
+Game::TerminalStatus Game::getTerminalStatus() const {
+    auto known = terminalStatus.load(std::memory_order_acquire);
+    if (known != 0) {
+        return TerminalStatus::decode(known);
     }
-    return false;
-}
 
-GameOver Game::isOver() const {
-    if (isMate())
-        return GameOver::MATE;
-    else if (isStalemate())
-        return GameOver::STALEMATE;
+    TerminalStatus status{};
+    status.check = isCheck(gameState.sideToMove);
+    status.legalMoveCount = getLegalMovesForPlayer(getCurrentPlayer()).size();
+    if (status.legalMoveCount == 0)
+        status.result = status.check ? GameOver::MATE : GameOver::STALEMATE;
     else if (isDrawByInsufficientMaterial())
-        return GameOver::INSUFFICIENT_MATERIAL;
+        status.result = GameOver::INSUFFICIENT_MATERIAL;
     else if (isDrawByRepetition())
-        return GameOver::THREEFOLD_REPETITION;
+        status.result = GameOver::THREEFOLD_REPETITION;
     else if (isDrawByFiftyMoveRule())
-        return GameOver::FIFTY_MOVE_RULE;
+        status.result = GameOver::FIFTY_MOVE_RULE;
     else
-        return GameOver::NOT_OVER;
+        status.result = GameOver::NOT_OVER;
+
+    terminalStatus.store(status.encode(), std::memory_order_release);
+    return status;
 }
 
-bool Game::isDrawByInsufficientMaterial() const {
-    auto whitePieces = std::vector<Piece *>(whitePlayer->getPieces());
-    auto blackPieces = std::vector<Piece *>(blackPlayer->getPieces());
+uint32_t Game::TerminalStatus::encode() const {
+    return 1 | static_cast<uint32_t>(check) << 1 | static_cast<uint32_t>(result) << 2 |
+           static_cast<uint32_t>(legalMoveCount) << 8;
+}
 
-    whitePieces.erase(std::remove_if(whitePieces.begin(), whitePieces.end(),
-                                     [](Piece *p) { return p->getType() == PieceType::KING; }), whitePieces.end());
-    blackPieces.erase(std::remove_if(blackPieces.begin(), blackPieces.end(),
-                                     [](Piece *p) { return p->getType() == PieceType::KING; }), blackPieces.end());
+Game::TerminalStatus Game::TerminalStatus::decode(uint32_t bits) {
+    return {((bits >> 1) & 1) != 0, bits >> 8, static_cast<GameOver>((bits >> 2) & 7)};
+}
 
-    if (whitePieces.empty() && blackPieces.empty())
-        return true;
-    else if (whitePieces.size() == 1 && blackPieces.empty()) {
-        auto whitePiece = whitePieces[0];
-        if (whitePiece->getType() == PieceType::BISHOP || whitePiece->getType() == PieceType::KNIGHT)
-            return true;
-    } else if (whitePieces.empty() && blackPieces.size() == 1) {
-        auto blackPiece = blackPieces[0];
-        if (blackPiece->getType() == PieceType::BISHOP || blackPiece->getType() == PieceType::KNIGHT)
-            return true;
-    } else if (whitePieces.size() == 1 && blackPieces.size() == 1) {
-        auto whitePiece = whitePieces[0];
-        auto blackPiece = blackPieces[0];
-        if ((whitePiece->getType() == PieceType::BISHOP || whitePiece->getType() == PieceType::KNIGHT) &&
-            (blackPiece->getType() == PieceType::BISHOP || blackPiece->getType() == PieceType::KNIGHT))
-            return true;
+bool Game::isDrawByInsufficientMaterial() const {
+    int minorPieces[2];
+    for (auto color: {Color::WHITE, Color::BLACK}) {
+        if (board->getPieceCount(color, PieceType::PAWN) > 0 || board->getPieceCount(color, PieceType::ROOK) > 0 ||
+            board->getPieceCount(color, PieceType::QUEEN) > 0) {
+            return false;
+        }
+        minorPieces[static_cast<int>(color)] =
+                board->getPieceCount(color, PieceType::BISHOP) + board->getPieceCount(color, PieceType::KNIGHT);
     }
-    return false;
+
+    // a lone king, or at most one knight or bishop on each side
+    if (minorPieces[0] <= 1 && minorPieces[1] <= 1)
+        return true;
+
+    // only bishops, all of them on fields of the same color
+    if (board->getPieceCount(Color::WHITE, PieceType::KNIGHT) > 0 ||
+        board->getPieceCount(Color::BLACK, PieceType::KNIGHT) > 0)
+        return false;
+    auto lightBishops = board->getBishopCount(Color::WHITE, true) + board->getBishopCount(Color::BLACK, true);
+    auto darkBishops = board->getBishopCount(Color::WHITE, false) + board->getBishopCount(Color::BLACK, false);
+    return lightBishops == 0 || darkBishops == 0;
 }
 
 bool Game::isDrawByRepetition() const {
-    return std::any_of(positionCount.begin(), positionCount.end(), [](const std::pair<std::string, int> &p) {
-        return p.second >= 3;
-    });
+    return getRepetitionCount() >= 2;
 }
 
-Position *Game::getEnPassantTargetPosition() const {
-    return gameState.enPassantTargetPosition;
+std::optional<Position> Game::getEnPassantTargetPosition() const {
+    return gameState.getEnPassantTarget();
 }
 
 bool Game::getCanWhiteKingsideCastle() const {
-    return gameState.canWhiteKingsideCastle;
+    return gameState.hasCastlingRight(GameState::WHITE_KINGSIDE);
 }
 
 bool Game::getCanWhiteQueensideCastle() const {
-    return gameState.canWhiteQueensideCastle;
+    return gameState.hasCastlingRight(GameState::WHITE_QUEENSIDE);
 }
 
 bool Game::getCanBlackKingsideCastle() const {
-    return gameState.canBlackKingsideCastle;
+    return gameState.hasCastlingRight(GameState::BLACK_KINGSIDE);
 }
 
 bool Game::getCanBlackQueensideCastle() const {
-    return gameState.canBlackQueensideCastle;
+    return gameState.hasCastlingRight(GameState::BLACK_QUEENSIDE);
+}
+
+const GameState &Game::getGameState() const {
+    return gameState;
 }
 
 int Game::getHalfmoveClock() const {
@@ -424,20 +471,22 @@ int Game::getFullmoveNumber() const {
     return gameState.fullmoveNumber;
 }
 
-Game Game::deepCopy() const {
-    auto copy = FENParser::parseGame(FENParser::gameToString(*this));
-    copy.setPositionCount(std::map<std::string, int>(this->getPositionCount()));
-    copy.gameState = this->gameState.copy(*this, copy);
-    copy.history = new HistoryManager(*this->history);  // TODO: Are there more params to copy?
-    return copy;
+uint64_t Game::getHash() const {
+    return positionHash;
 }
 
-std::map<std::string, int> Game::getPositionCount() const {
-    return positionCount;
-}
-
-void Game::setPositionCount(std::map<std::string, int> count) {
-    positionCount = std::move(count);
+int Game::getRepetitionCount() const {
+    // the position can only repeat since the last capture or pawn move, with the same side to move
+    const auto &records = history->getHistory();
+    auto played = records.size() - history->getMovesIntoThePast();
+    auto reversiblePlies = std::min<size_t>(gameState.halfmoveClock, played);
+    int count = 0;
+    for (size_t plies = 4; plies <= reversiblePlies; plies += 2) {
+        if (records[played - plies].hash == positionHash) {
+            count++;
+        }
+    }
+    return count;
 }
 
 bool Game::isDrawByFiftyMoveRule() const {
@@ -449,27 +498,26 @@ void Game::undoMove() {
         return;
     }
 
-    this->switchCurrentPlayer();
-    auto fenOfCurrentBoard = FENParser::boardToString(*(this->board));
-    positionCount[fenOfCurrentBoard]--;
-    auto moveToReverse = history->getMoveToUndo();
-    loadPreviousGamestate();
+    const auto &record = history->getRecordToUndo();
+    auto moveToReverse = recordedMove(record);
+    this->gameState = record.previousState(this->gameState);
+    this->positionHash = record.hash;
+    this->terminalStatus = 0;
     if (moveToReverse.isCapture()) {
         auto captured = moveToReverse.getCapturedPiece();
         auto player = (captured->getColor() == Color::WHITE) ? whitePlayer : blackPlayer;
         player->getPieces().push_back(captured);
     }
     if (moveToReverse.isDoublePawnMove()) {
-        this->gameState.enPassantTargetPosition = nullptr;
-        auto movedPawn = dynamic_cast<Pawn *>(moveToReverse.getPiece());
+        auto movedPawn = static_cast<Pawn *>(moveToReverse.getPiece());
         movedPawn->setIsEnPassantTarget(false);
     }
     if (moveToReverse.getPromoteTo() != PieceType::NONE) {
-        gameState.currentPlayer->getPieces().push_back(moveToReverse.getPiece());
-        gameState.currentPlayer->removePiece(getPiece(moveToReverse.getTo()));
+        getCurrentPlayer()->getPieces().push_back(moveToReverse.getPiece());
+        getCurrentPlayer()->removePiece(getPiece(moveToReverse.getTo()));
     }
-    bool isEnPassant = (getEnPassantTargetPosition() == nullptr ||
-                        moveToReverse.getTo() != *(getEnPassantTargetPosition())) ? false : true;
+    auto enPassantTarget = getEnPassantTargetPosition();
+    bool isEnPassant = enPassantTarget.has_value() && moveToReverse.getTo() == *enPassantTarget;
 
 
     board->reverseMove(moveToReverse, isEnPassant);
@@ -477,8 +525,20 @@ void Game::undoMove() {
         getEnPassantTargetPiece()->setIsEnPassantTarget(true);
 }
 
+Move Game::recordedMove(const PlyRecord &record) const {
+    auto movingColor = (gameState.sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    auto movedPiece = (record.getPromoteTo() != PieceType::NONE)
+                      ? board->restorePiece(PieceType::PAWN, movingColor)
+                      : getPiece(record.getTo());
+    auto capturedPiece = (record.getCapturedType() != PieceType::NONE)
+                         ? board->restorePiece(record.getCapturedType(), gameState.sideToMove)
+                         : nullptr;
+    return {record.getFrom(), record.getTo(), movedPiece, capturedPiece, record.getPromoteTo()};
+}
+
 void Game::switchCurrentPlayer() {
-    gameState.currentPlayer = (gameState.currentPlayer == whitePlayer) ? blackPlayer : whitePlayer;
+    gameState.sideToMove = (gameState.sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    terminalStatus = 0;
 }
 
 void Game::redoMove() {
@@ -486,21 +546,30 @@ void Game::redoMove() {
         return;
     }
 
-    auto moveToReverse = history->getMoveToRedo();
-    this->makeMove(moveToReverse, false);
+    const auto &record = history->getRecordToRedo();
+    this->makeMove(Move::fromPositions(*this, record.getFrom(), record.getTo(), record.getPromoteTo()), false);
 }
 
 Player *Game::getCurrentPlayer() const {
-    return gameState.currentPlayer;
+    return (gameState.sideToMove == Color::WHITE) ? whitePlayer : blackPlayer;
 }
 
 int Game::getMovesIntoThePast() const {
     return history->getMovesIntoThePast();
 }
 
-void Game::loadPreviousGamestate() {
-    auto state = this->history->getHistory()[this->history->getHistory().size() - getMovesIntoThePast()].state;
-    this->gameState = state.copy(*this, *this);
+const HistoryManager &Game::getHistory() const {
+    return *history;
+}
+
+void Game::swapHistory(HistoryManager &other) {
+    std::swap(*history, other);
+    // repetitions depend on the recorded moves
+    terminalStatus = 0;
+}
+
+void Game::setMoveCache(MoveCache *cache) {
+    moveCache = cache;
 }
 
 
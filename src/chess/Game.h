@@ -9,10 +9,13 @@
 #define CHESS_GAME_H
 
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
-#include <map>
+#include <optional>
 #include "GameState.h"
+#include "CompactPosition.h"
 
 
 class Board;
@@ -22,41 +25,53 @@ class Piece;
 class Position;
 class King;
 class Pawn;
-class Move;
 class HistoryManager;
-enum class Color;
+class MoveCache;
+struct PlyRecord;
+enum class Color : uint8_t;
 enum class GameOver;
 
 
-
+/**
+ * The const queries - the moves, checks, the result of the game and the FEN export - only read the game and can be
+ * made from many threads at once, as long as none of them changes the game in the meantime. A thread which makes
+ * moves works on its own copy.
+ */
 class Game {
 private:
+    /**
+     * Status of the current position computed in a single pass over the legal moves
+     */
+    struct TerminalStatus {
+        bool check;
+        size_t legalMoveCount;
+        GameOver result;
+
+        /**
+         * Bit 0 set, bit 1 - check, bits 2-4 - result, bits 8 and up - legal move count
+         */
+        uint32_t encode() const;
+
+        static TerminalStatus decode(uint32_t bits);
+    };
+
     Board *board;
     Player *whitePlayer;
     Player *blackPlayer;
-    std::map<std::string, int> positionCount;
     GameState gameState;
-    HistoryManager *history;
-
-
-    bool isCastlingObscuredByOpponent(Move &move) const;
-
+    uint64_t positionHash;
     /**
-     * Utilites for checking whether the current player can castle - whether the flags are true and
-     * there are no pieces between the king and rook
-     * */
-    bool possibleKingsideCastlingThisRound() const;
-
-    bool possibleQueensideCastlingThisRound() const;
-
-    bool noPiecesBetweenKingAndRook(const Piece *king, const Piece *rook) const;
-
+     * Encoded TerminalStatus, 0 until it is computed. Memoized until the position changes - on makeMove,
+     * undoMove or switchCurrentPlayer. Atomic, because concurrent const queries may all compute it and store
+     * the same value.
+     */
+    mutable std::atomic<uint32_t> terminalStatus{0};
+    HistoryManager *history;
     /**
-     *Generate a move object for a castle in a given direction based on the currentPlayer parameter
-     * */
-    Move generateKingSideCastle() const;
+     * Shared cache of the legal moves, not owned, nullptr if the moves are always generated
+     */
+    MoveCache *moveCache = nullptr;
 
-    Move generateQueenSideCastle() const;
 
     /**
      * In a situation where there are 4 or less pieces on the board. Player has only a king and a knight/bishop -> he
@@ -66,21 +81,48 @@ private:
     bool isDrawByRepetition() const;
     bool isDrawByFiftyMoveRule() const;
 
+    TerminalStatus getTerminalStatus() const;
+
+    void swap(Game &other) noexcept;
+
     /**
-     * Create a deep copy of the game. Inherits all of the properties.
-     * */
-    Game deepCopy() const;
+     * Move object of a recorded ply, to be reversed on the board - captured pieces and promoted pawns
+     * are taken from the pieces which are off the board
+     */
+    Move recordedMove(const PlyRecord &record) const;
 
 
 public:
     Game(std::string whiteName = "Player 1", std::string blackName = "Player 2");
 
-    Game(Board *board, Player *whitePlayer, Player *blackPlayer, Player *currentPlayer, bool canWhiteKingsideCastle,
-         bool canWhiteQueensideCastle, bool canBlackKingsideCastle, bool canBlackQueensideCastle,
-         Position *enPassantTarget, int halfmoveClock, int fullmoveNumber);
+    Game(Board *board, Player *whitePlayer, Player *blackPlayer, const GameState &gameState);
+
+    /**
+     * Game starting from the position, with new piece objects and default player names
+     */
+    explicit Game(const CompactPosition &position);
+
+    /**
+     * Independent copy of the game - new board, pieces and players in the same state and a copy of the history,
+     * which can be analysed on another thread while the original is being played
+     */
+    Game(const Game &other);
+
+    /**
+     * Takes over the board, the players and the history, the other game can only be destroyed or assigned to
+     */
+    Game(Game &&other) noexcept;
+
+    Game &operator=(const Game &other);
+
+    Game &operator=(Game &&other) noexcept;
 
     ~Game();
 
+    /**
+     * Result of the game in the current position, computed once per position together with
+     * isMate, isStalemate, isCurrentPlayerInCheck and getLegalMoveCount
+     */
     GameOver isOver() const;
 
     Board *getBoard() const;
@@ -95,10 +137,24 @@ public:
 
     Player *getCurrentPlayer() const;
 
-    Position *getEnPassantTargetPosition() const;
+    std::optional<Position> getEnPassantTargetPosition() const;
 
     int getMovesIntoThePast() const;
 
+    const HistoryManager &getHistory() const;
+
+    /**
+     * Exchange the recorded moves of the game with the given ones without copying them, so a caller which keeps
+     * the history between short-lived games can lend it to a game and take it back
+     */
+    void swapHistory(HistoryManager &other);
+
+    /**
+     * Take the legal moves of the positions from the cache, which must outlive the game, or generate them every time
+     * if it is nullptr. Copies of the game use the same cache.
+     */
+    void setMoveCache(MoveCache *cache);
+
     void makeMove(const Move& move, bool updateHistory = true);
     void undoMove();
     void redoMove();
@@ -125,22 +181,49 @@ public:
      * */
     std::vector<Move> getLegalMovesFrom(Position position) const;
 
+    /**
+     * Whether the move is legal for the side to move, checked directly without generating the other moves.
+     * Agrees with finding the move in getLegalMovesFrom, except that a pawn moving to the last rank must have
+     * the promotion piece chosen. The moved and captured pieces must be the ones on the board.
+     */
+    bool isLegal(const Move &move) const;
+
     /**
      * All possible moves for a player. getLegalMovesFrom for all of the fields controlled by his pieces combined.
      * */
     std::vector<Move> getLegalMovesForPlayer(Player *player) const;
 
+    /**
+     * Legal moves of the side to move written to the list in place of its contents, so a caller asking
+     * for them at every ply can reuse one buffer
+     */
+    void getLegalMoves(std::vector<Move> &moves) const;
+
+    /**
+     * Number of legal move sequences of the given length from the current position, with a promotion counted once
+     * for every piece the pawn can promote to. Used to verify and benchmark the move generator.
+     * https://www.chessprogramming.org/Perft
+     */
+    size_t perft(int depth);
+
     bool isMate() const;
 
     bool isStalemate() const;
 
+    bool isCurrentPlayerInCheck() const;
+
+    size_t getLegalMoveCount() const;
+
     bool isCheck(Color colorOfCheckedKing) const;
 
+    /**
+     * Whether any of the player's pieces attacks the field
+     */
     bool isFieldControlledByPlayer(const Position &pos, Color colorOfPlayer) const;
 
     /**
      * Get the pawn threatened by en passant based on enPassantTargetLocation
-     * @throws std::bad_cast if the piece is not a pawn or there is no piece
+     * @return nullptr if there is no en passant target or no opponent's pawn stands behind it
      */
     Pawn *getEnPassantTargetPiece() const;
 
@@ -156,13 +239,20 @@ public:
 
     int getFullmoveNumber() const;
 
-    std::map<std::string, int> getPositionCount() const;
+    const GameState &getGameState() const;
 
-    void setPositionCount(std::map<std::string, int> count);
+    /**
+     * Zobrist hash of the current position
+     */
+    uint64_t getHash() const;
 
-    void switchCurrentPlayer();
+    /**
+     * Number of earlier occurrences of the current position, found by walking the hashes of the history
+     * back two plies at a time, only as far as the halfmove clock allows
+     */
+    int getRepetitionCount() const;
 
-    void loadPreviousGamestate();
+    void switchCurrentPlayer();
 };
 
 std::vector<std::string> split(const std::string &txt, char ch);
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "GameArchive.h"
+#include "PGNParser.h"
+#include "FENParser.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "ChessExceptions.h"
+#include "pieces/PieceType.h"
+
+namespace {
+    const std::vector<std::string> resultCodes = {"*", "1-0", "0-1", "1/2-1/2"};
+    const PieceType promotions[] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT};
+
+    int squareIndex(Position position) {
+        return (position.getRow() - 1) * 8 + position.getCol() - 1;
+    }
+
+    int canonicalKey(const Move &move, PieceType promoteTo) {
+        return (squareIndex(move.getFrom()) * 64 + squareIndex(move.getTo())) * 8 + static_cast<int>(promoteTo);
+    }
+
+    int canonicalKey(const Move &move) {
+        return canonicalKey(move, move.getPromoteTo());
+    }
+
+    /**
+     * Number of entries of the move in the canonical list, one for every promotion piece
+     */
+    size_t canonicalCount(const Move &move) {
+        return move.resultsInPromotion() ? std::size(promotions) : 1;
+    }
+}
+
+Game GameArchive::initialGame(const ArchivedGame &archivedGame) {
+    for (const auto &tag: archivedGame.tags) {
+        if (tag.first == "FEN") {
+            return FENParser::parseGame(tag.second);
+        }
+    }
+    return {};
+}
+
+std::vector<Move> GameArchive::canonicalLegalMoves(const Game &game) {
+    std::vector<Move> moves;
+    for (const auto &move: game.getLegalMovesForPlayer(game.getCurrentPlayer())) {
+        if (move.resultsInPromotion()) {
+            for (auto promoteTo: promotions) {
+                moves.emplace_back(move.getFrom(), move.getTo(), move.getPiece(), move.getCapturedPiece(), promoteTo);
+            }
+        } else {
+            moves.push_back(move);
+        }
+    }
+
+    std::sort(moves.begin(), moves.end(), [](const Move &lhs, const Move &rhs) {
+        return canonicalKey(lhs) < canonicalKey(rhs);
+    });
+    return moves;
+}
+
+uint8_t GameArchive::encodeMove(const Game &game, const Move &move) {
+    std::vector<Move> moves;
+    return GameArchive::encodeMove(game, move, moves);
+}
+
+uint8_t GameArchive::encodeMove(const Game &game, const Move &move, std::vector<Move> &moves) {
+    // the index in the canonical order is the number of canonical keys smaller than the key of the move
+    game.getLegalMoves(moves);
+    auto key = canonicalKey(move);
+    size_t index = 0;
+    bool found = false;
+    for (const auto &legalMove: moves) {
+        if (legalMove.resultsInPromotion()) {
+            for (auto promoteTo: promotions) {
+                auto legalKey = canonicalKey(legalMove, promoteTo);
+                index += (legalKey < key);
+                found |= (legalKey == key);
+            }
+        } else {
+            auto legalKey = canonicalKey(legalMove);
+            index += (legalKey < key);
+            found |= (legalKey == key);
+        }
+    }
+    if (!found) {
+        throw IllegalMoveException("Cannot encode illegal move " + move.toSmithNotation());
+    }
+    return static_cast<uint8_t>(index);
+}
+
+Move GameArchive::decodeMove(const Game &game, uint8_t moveIndex) {
+    std::vector<Move> moves;
+    return GameArchive::decodeMove(game, moveIndex, moves);
+}
+
+Move GameArchive::decodeMove(const Game &game, uint8_t moveIndex, std::vector<Move> &moves) {
+    // the canonical order sorts by the source field first - find the field holding the index by counting,
+    // then order only the few moves from it
+    game.getLegalMoves(moves);
+    std::array<size_t, 64> countsFrom{};
+    for (const auto &move: moves) {
+        countsFrom[squareIndex(move.getFrom())] += canonicalCount(move);
+    }
+    size_t remaining = moveIndex;
+    int from = 0;
+    while (from < 64 && remaining >= countsFrom[from]) {
+        remaining -= countsFrom[from++];
+    }
+    if (from == 64) {
+        throw ArchiveException("Invalid move index " + std::to_string(moveIndex));
+    }
+
+    // a queen has at most 27 moves and a pawn 3 targets with 4 promotion pieces each
+    std::array<std::pair<int, const Move *>, 32> movesFrom;
+    size_t count = 0;
+    for (const auto &move: moves) {
+        if (squareIndex(move.getFrom()) != from) {
+            continue;
+        }
+        if (move.resultsInPromotion()) {
+            for (auto promoteTo: promotions) {
+                movesFrom[count++] = {canonicalKey(move, promoteTo), &move};
+            }
+        } else {
+            movesFrom[count++] = {canonicalKey(move), &move};
+        }
+    }
+    auto chosen = movesFrom.begin() + static_cast<std::ptrdiff_t>(remaining);
+    std::nth_element(movesFrom.begin(), chosen, movesFrom.begin() + static_cast<std::ptrdiff_t>(count));
+
+    const auto &move = *chosen->second;
+    if (!move.resultsInPromotion()) {
+        return move;
+    }
+    auto promoteTo = static_cast<PieceType>(chosen->first % 8);
+    return {move.getFrom(), move.getTo(), move.getPiece(), move.getCapturedPiece(), promoteTo};
+}
+
+ArchivedGame GameArchive::fromPgn(const PgnGame &pgnGame) {
+    ArchivedGame archivedGame;
+    archivedGame.tags = pgnGame.tags;
+    archivedGame.result = pgnGame.result;
+    if (archivedGame.result.empty()) {
+        archivedGame.result = pgnGame.hasTag("Result") ? pgnGame.getTag("Result") : "*";
+    }
+
+    std::unique_ptr<Game> game(new Game(PGNParser::initialGame(pgnGame)));
+    archivedGame.moves.reserve(pgnGame.moves.size());
+    std::vector<Move> moves;
+    for (const auto &san: pgnGame.moves) {
+        auto move = PGNParser::parseSan(san, *game);
+        archivedGame.moves.push_back(GameArchive::encodeMove(*game, move, moves));
+        game->makeMove(move);
+    }
+    return archivedGame;
+}
+
+PgnGame GameArchive::toPgn(const ArchivedGame &archivedGame) {
+    PgnGame pgnGame;
+    pgnGame.tags = archivedGame.tags;
+    pgnGame.result = archivedGame.result;
+
+    std::unique_ptr<Game> game(new Game(GameArchive::initialGame(archivedGame)));
+    pgnGame.moves.reserve(archivedGame.moves.size());
+    std::vector<Move> moves;
+    for (auto moveIndex: archivedGame.moves) {
+        auto move = GameArchive::decodeMove(*game, moveIndex, moves);
+        pgnGame.moves.push_back(PGNParser::moveToSan(move, *game));
+        game->makeMove(move);
+    }
+    return pgnGame;
+}
+
+void GameArchive::replay(const ArchivedGame &archivedGame,
+                         const std::function<void(const Game &, size_t)> &visitor) {
+    std::unique_ptr<Game> game(new Game(GameArchive::initialGame(archivedGame)));
+    visitor(*game, 0);
+    std::vector<Move> moves;
+    for (size_t ply = 0; ply < archivedGame.moves.size(); ply++) {
+        game->makeMove(GameArchive::decodeMove(*game, archivedGame.moves[ply], moves));
+        visitor(*game, ply + 1);
+    }
+}
+
+
+GameArchiveWriter::GameArchiveWriter(const std::string &path)
+        : file(path, std::ios::binary | std::ios::trunc), position(0), closed(false) {
+    if (!file) {
+        throw ArchiveException("Cannot open " + path + " for writing");
+    }
+    // placeholder for the header, filled in on close when the game count and index offset are known
+    std::vector<char> header(GameArchive::headerSize, 0);
+    write(header.data(), header.size());
+}
+
+GameArchiveWriter::~GameArchiveWriter() {
+    if (!closed) {
+        try {
+            close();
+        } catch (const ArchiveException &e) {
+            // destructor must not throw, the archive is left incomplete
+        }
+    }
+}
+
+void GameArchiveWriter::write(const void *data, size_t size) {
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    if (!file) {
+        throw ArchiveException("Cannot write to the archive file");
+    }
+    position += size;
+}
+
+void GameArchiveWriter::writeInteger(uint64_t value, size_t size) {
+    uint8_t bytes[8];
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    write(bytes, size);
+}
+
+void GameArchiveWriter::addGame(const ArchivedGame &archivedGame) {
+    if (closed) {
+        throw ArchiveException("Cannot add a game to a closed archive");
+    }
+    if (archivedGame.tags.size() > UINT16_MAX) {
+        throw ArchiveException("Too many tags in a game");
+    }
+    for (const auto &tag: archivedGame.tags) {
+        if (tag.first.size() > UINT8_MAX || tag.second.size() > UINT16_MAX) {
+            throw ArchiveException("Tag " + tag.first.substr(0, 32) + " is too long");
+        }
+    }
+    auto resultCode = std::find(resultCodes.begin(), resultCodes.end(), archivedGame.result);
+    if (resultCode == resultCodes.end()) {
+        throw ArchiveException("Invalid game result " + archivedGame.result);
+    }
+
+    offsets.push_back(position);
+    writeInteger(archivedGame.tags.size(), 2);
+    for (const auto &tag: archivedGame.tags) {
+        writeInteger(tag.first.size(), 1);
+        write(tag.first.data(), tag.first.size());
+        writeInteger(tag.second.size(), 2);
+        write(tag.second.data(), tag.second.size());
+    }
+    writeInteger(resultCode - resultCodes.begin(), 1);
+    writeInteger(archivedGame.moves.size(), 4);
+    write(archivedGame.moves.data(), archivedGame.moves.size());
+}
+
+void GameArchiveWriter::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+
+    auto indexOffset = position;
+    for (auto offset: offsets) {
+        writeInteger(offset, 8);
+    }
+
+    file.seekp(0);
+    write(GameArchive::magic, sizeof(GameArchive::magic));
+    writeInteger(GameArchive::version, 2);
+    writeInteger(0, 2);
+    writeInteger(offsets.size(), 4);
+    writeInteger(indexOffset, 8);
+    file.close();
+}
+
+
+GameArchiveReader::GameArchiveReader(const std::string &path) : data(nullptr), size(0), gameCount(0), index(nullptr) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ArchiveException("Cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t) GameArchive::headerSize) {
+        ::close(fd);
+        throw ArchiveException(path + " is not a game archive");
+    }
+
+    size = fileStat.st_size;
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw ArchiveException("Cannot map " + path + ": " + strerror(errno));
+    }
+    data = static_cast<const uint8_t *>(mapping);
+
+    auto indexOffset = readInteger(12, 8);
+    gameCount = readInteger(8, 4);
+    if (memcmp(data, GameArchive::magic, sizeof(GameArchive::magic)) != 0 ||
+        readInteger(4, 2) != GameArchive::version ||
+        indexOffset > size || (size - indexOffset) / 8 < gameCount) {
+        munmap(const_cast<uint8_t *>(data), size);
+        throw ArchiveException(path + " is not a valid game archive");
+    }
+    index = data + indexOffset;
+}
+
+GameArchiveReader::~GameArchiveReader() {
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+uint64_t GameArchiveReader::readInteger(size_t offset, size_t integerSize) const {
+    if (offset > size || size - offset < integerSize) {
+        throw ArchiveException("Truncated game archive");
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < integerSize; i++) {
+        value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+size_t GameArchiveReader::getGameCount() const {
+    return gameCount;
+}
+
+ArchivedGame GameArchiveReader::getGame(size_t gameIndex) const {
+    if (gameIndex >= gameCount) {
+        throw ArchiveException("Game index out of range");
+    }
+
+    ArchivedGame archivedGame;
+    size_t offset = readInteger(index - data + 8 * gameIndex, 8);
+
+    auto tagCount = readInteger(offset, 2);
+    offset += 2;
+    archivedGame.tags.reserve(tagCount);
+    for (size_t i = 0; i < tagCount; i++) {
+        auto nameLength = readInteger(offset, 1);
+        if (size - offset - 1 < nameLength) {
+            throw ArchiveException("Truncated game archive");
+        }
+        std::string name(reinterpret_cast<const char *>(data + offset + 1), nameLength);
+        offset += 1 + nameLength;
+
+        auto valueLength = readInteger(offset, 2);
+        if (size - offset - 2 < valueLength) {
+            throw ArchiveException("Truncated game archive");
+        }
+        std::string value(reinterpret_cast<const char *>(data + offset + 2), valueLength);
+        offset += 2 + valueLength;
+
+        archivedGame.tags.emplace_back(std::move(name), std::move(value));
+    }
+
+    auto resultCode = readInteger(offset, 1);
+    if (resultCode >= resultCodes.size()) {
+        throw ArchiveException("Invalid game result code");
+    }
+    archivedGame.result = resultCodes[resultCode];
+
+    auto plyCount = readInteger(offset + 1, 4);
+    offset += 5;
+    if (size - offset < plyCount) {
+        throw ArchiveException("Truncated game archive");
+    }
+    archivedGame.moves.assign(data + offset, data + offset + plyCount);
+    return archivedGame;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_GAMEARCHIVE_H
+#define CHESS_GAMEARCHIVE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <utility>
+
+class Game;
+class Move;
+struct PgnGame;
+
+/**
+ * Game stored in the binary archive format - tags, result and one byte per ply. Each byte is the index of the played
+ * move in the canonical list of legal moves of the position it was played in.
+ */
+struct ArchivedGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::string result;
+    std::vector<uint8_t> moves;
+};
+
+/**
+ * Encoding of games as indexes into the legal move list.
+ *
+ * File layout (all integers little-endian):
+ *  header  - magic "CHGA", u16 version, u16 reserved, u32 game count, u64 offset of the index
+ *  games   - u16 tag count, tags as (u8 name length, name, u16 value length, value), u8 result code,
+ *            u32 ply count, one byte per ply
+ *  index   - u64 offset of each game, which allows to seek to game N in constant time
+ */
+class GameArchive {
+private:
+    static Game initialGame(const ArchivedGame &archivedGame);
+
+    /**
+     * encodeMove with the legal moves generated into the given buffer, reused between the plies of a game
+     */
+    static uint8_t encodeMove(const Game &game, const Move &move, std::vector<Move> &moves);
+
+    /**
+     * decodeMove with the legal moves generated into the given buffer, reused between the plies of a game
+     */
+    static Move decodeMove(const Game &game, uint8_t moveIndex, std::vector<Move> &moves);
+
+public:
+    static constexpr char magic[4] = {'C', 'H', 'G', 'A'};
+    static constexpr uint16_t version = 1;
+    static constexpr size_t headerSize = 20;
+
+    /**
+     * Legal moves of the current player in canonical order - sorted by source field, target field and promotion,
+     * with a separate move for every possible promotion piece. The order does not depend on the order in which
+     * moves are generated, so archives stay readable when move generation changes.
+     */
+    static std::vector<Move> canonicalLegalMoves(const Game &game);
+
+    /**
+     * @throws IllegalMoveException if the move is not legal in the current position
+     */
+    static uint8_t encodeMove(const Game &game, const Move &move);
+
+    /**
+     * @throws ArchiveException if there is no legal move with such index in the current position
+     */
+    static Move decodeMove(const Game &game, uint8_t moveIndex);
+
+    /**
+     * @throws IllegalMoveException or FenException if the game is not legal
+     */
+    static ArchivedGame fromPgn(const PgnGame &pgnGame);
+
+    static PgnGame toPgn(const ArchivedGame &archivedGame);
+
+    /**
+     * Replay the game from its starting position, calling the visitor with the position before the first move
+     * and after every move, together with the number of plies played so far
+     */
+    static void replay(const ArchivedGame &archivedGame, const std::function<void(const Game &, size_t)> &visitor);
+};
+
+/**
+ * Writes games sequentially into a new archive file, the index is written on close
+ */
+class GameArchiveWriter {
+private:
+    std::ofstream file;
+    std::vector<uint64_t> offsets;
+    uint64_t position;
+    bool closed;
+
+    void write(const void *data, size_t size);
+
+    void writeInteger(uint64_t value, size_t size);
+
+public:
+    explicit GameArchiveWriter(const std::string &path);
+
+    ~GameArchiveWriter();
+
+    void addGame(const ArchivedGame &archivedGame);
+
+    void close();
+};
+
+/**
+ * Read-only view of an archive file mapped into memory
+ */
+class GameArchiveReader {
+private:
+    const uint8_t *data;
+    size_t size;
+    uint32_t gameCount;
+    const uint8_t *index;
+
+    uint64_t readInteger(size_t offset, size_t size) const;
+
+public:
+    /**
+     * @throws ArchiveException if the file cannot be mapped or is not a valid archive
+     */
+    explicit GameArchiveReader(const std::string &path);
+
+    ~GameArchiveReader();
+
+    GameArchiveReader(const GameArchiveReader &) = delete;
+
+    GameArchiveReader &operator=(const GameArchiveReader &) = delete;
+
+    size_t getGameCount() const;
+
+    ArchivedGame getGame(size_t gameIndex) const;
+};
+
+
+#endif //CHESS_GAMEARCHIVE_H
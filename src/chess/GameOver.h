@@ -1,4 +1,3 @@
-
 /*
  * Copyright (c) 2023.
  * Maksym Bieńkowski
@@ -6,6 +5,9 @@
  * Michał Łuszczek
  */
 
+#ifndef CHESS_GAMEOVER_H
+#define CHESS_GAMEOVER_H
+
 enum class GameOver {
     NOT_OVER,
     MATE,
@@ -13,4 +15,6 @@ enum class GameOver {
     INSUFFICIENT_MATERIAL,
     FIFTY_MOVE_RULE,
     THREEFOLD_REPETITION,
-};
\ No newline at end of file
+};
+
+#endif //CHESS_GAMEOVER_H
@@ -1,12 +1,11 @@
 #include "GameState.h"
-#include "Player.h"
 #include "Color.h"
 #include "Move.h"
-#include "Game.h"
-#include "pieces/Pawn.h"
+#include "pieces/Piece.h"
+#include "pieces/PieceType.h"
 
 void GameState::updateFullmoveNumber() {
-    if (this->currentPlayer->getColor() == Color::BLACK) {
+    if (this->sideToMove == Color::BLACK) {
         this->fullmoveNumber++;
     }
 }
@@ -18,85 +17,59 @@ void GameState::updateHalfmoveClock(const Move &move) {
     }
 }
 
-void GameState::updateEnPassantTarget(Pawn *oldEnPassantTarget) {
-    if (this->enPassantTargetPosition != nullptr) {
-        oldEnPassantTarget->setIsEnPassantTarget(false);
-        this->enPassantTargetPosition = nullptr;
-    }
-}
-
 void GameState::updateCastling(const Move &move) {
+    auto colorRights = (move.getPiece()->getColor() == Color::WHITE)
+                       ? WHITE_KINGSIDE | WHITE_QUEENSIDE
+                       : BLACK_KINGSIDE | BLACK_QUEENSIDE;
     if (move.getPiece()->getType() == PieceType::KING) {
-        if (move.getPiece()->getColor() == Color::WHITE) {
-            this->canWhiteKingsideCastle = false;
-            this->canWhiteQueensideCastle = false;
-        } else {
-            this->canBlackKingsideCastle = false;
-            this->canBlackQueensideCastle = false;
-        }
-
+        this->removeCastlingRight(colorRights);
     } else if (move.getPiece()->getType() == PieceType::ROOK) {
-        if (move.getPiece()->getColor() == Color::WHITE) {
-            if (move.getFrom().getRow() == 1 && move.getFrom().getCol() == 1) {
-                this->canWhiteQueensideCastle = false;
-            } else if (move.getFrom().getRow() == 1 && move.getFrom().getCol() == 8) {
-                this->canWhiteKingsideCastle = false;
-            }
-        } else {
-            if (move.getFrom().getRow() == 8 && move.getFrom().getCol() == 1) {
-                this->canBlackQueensideCastle = false;
-            } else if (move.getFrom().getRow() == 8 && move.getFrom().getCol() == 8) {
-                this->canBlackKingsideCastle = false;
-            }
-        }
+        this->removeCastlingRight(castlingRightOfRookSquare(move.getFromSquare()) & colorRights);
     }
     if (move.isCapture() && move.getCapturedPiece()->getType() == PieceType::ROOK) {
-        this->updateCastlingAfterRookCapture(move.getCapturedPiece());
+        this->removeCastlingRight(castlingRightOfRookSquare(move.getToSquare()));
     }
 }
 
-void GameState::updateCastlingAfterRookCapture(const Piece *capturedRook) {
-    if (capturedRook->getPosition() == Position(1, 1)) {
-        this->canWhiteQueensideCastle = false;
-    } else if (capturedRook->getPosition() == Position(1, 8)) {
-        this->canWhiteKingsideCastle = false;
-    }
-    if (capturedRook->getPosition() == Position(8, 1)) {
-        this->canBlackQueensideCastle = false;
-    } else if (capturedRook->getPosition() == Position(8, 8)) {
-        this->canBlackKingsideCastle = false;
+uint8_t GameState::castlingRightOfRookSquare(Square square) {
+    if (square == Square::at(0, 0)) {
+        return WHITE_QUEENSIDE;
+    } else if (square == Square::at(0, 7)) {
+        return WHITE_KINGSIDE;
+    } else if (square == Square::at(7, 0)) {
+        return BLACK_QUEENSIDE;
+    } else if (square == Square::at(7, 7)) {
+        return BLACK_KINGSIDE;
     }
+    return 0;
 }
 
-void GameState::update(const Move &move, Pawn *oldEnPassantTarget) {
-    this->updateFullmoveNumber();
-    this->updateHalfmoveClock(move);
-    this->updateEnPassantTarget(oldEnPassantTarget);
-    this->updateCastling(move);
+GameState GameState::initial() {
+    return {Color::WHITE, ALL_CASTLING_RIGHTS, NO_EN_PASSANT, 0, 1};
+}
+
+bool GameState::hasCastlingRight(uint8_t right) const {
+    return (castlingRights & right) != 0;
 }
 
-GameState GameState::copy(const Game &original, const Game &copied) const {
-    return {
-            (original.getCurrentPlayer()->getColor() == Color::WHITE) ? copied.getWhitePlayer() : copied.getBlackPlayer(),
-            canWhiteKingsideCastle,
-            canWhiteQueensideCastle,
-            canBlackKingsideCastle,
-            canBlackQueensideCastle,
-            (enPassantTargetPosition != nullptr) ? Position::copy(*enPassantTargetPosition) : nullptr,
-            halfmoveClock,
-            fullmoveNumber
-    };
+void GameState::removeCastlingRight(uint8_t right) {
+    castlingRights &= ~right;
 }
 
-GameState::GameState(Player *currentPlayer, bool canWhiteKingsideCastle, bool canWhiteQueensideCastle,
-                     bool canBlackKingsideCastle, bool canBlackQueensideCastle, Position *enPassantTargetPosition,
-                     int halfmoveClock, int fullmoveNumber) : currentPlayer(currentPlayer),
-                                                              canWhiteKingsideCastle(canWhiteKingsideCastle),
-                                                              canWhiteQueensideCastle(canWhiteQueensideCastle),
-                                                              canBlackKingsideCastle(canBlackKingsideCastle),
-                                                              canBlackQueensideCastle(canBlackQueensideCastle),
-                                                              enPassantTargetPosition(enPassantTargetPosition),
-                                                              halfmoveClock(halfmoveClock),
-                                                              fullmoveNumber(fullmoveNumber) {}
+std::optional<Position> GameState::getEnPassantTarget() const {
+    if (enPassantSquare == NO_EN_PASSANT) {
+        return std::nullopt;
+    }
+    return Position(getEnPassantSquare());
+}
+
+void GameState::setEnPassantTarget(const std::optional<Position> &target) {
+    enPassantSquare = target.has_value() ? static_cast<int8_t>(target->getIndex()) : NO_EN_PASSANT;
+}
 
-GameState::GameState() {}
+void GameState::update(const Move &move) {
+    this->updateFullmoveNumber();
+    this->updateHalfmoveClock(move);
+    this->enPassantSquare = NO_EN_PASSANT;
+    this->updateCastling(move);
+}
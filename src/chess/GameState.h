@@ -1,14 +1,19 @@
 #ifndef CHESS_GAMESTATE_H
 #define CHESS_GAMESTATE_H
 
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include "Color.h"
+#include "Position.h"
 
-class Position;
 class Move;
-class Player;
-class Pawn;
 class Piece;
-class Game;
 
+/**
+ * Part of the game state which cannot be read from the board. Trivially copyable and 8 bytes large, so history
+ * snapshots and copies of the game are plain memory copies.
+ */
 struct GameState {
 private:
     void updateFullmoveNumber();
@@ -22,30 +27,54 @@ private:
      **/
     void updateCastling(const Move &move);
 
-    void updateCastlingAfterRookCapture(const Piece *capturedRook);
-
-    void updateEnPassantTarget(Pawn *oldEnPassantTarget);
+    /**
+     * Castling right lost when the rook leaves or is captured on the given field, 0 if it is not a rook's
+     * initial field
+     */
+    static uint8_t castlingRightOfRookSquare(Square square);
 
 public:
-    Player *currentPlayer;
-    bool canWhiteKingsideCastle;
-    bool canWhiteQueensideCastle;
-    bool canBlackKingsideCastle;
-    bool canBlackQueensideCastle;
-    Position *enPassantTargetPosition;
-    int halfmoveClock;
-    int fullmoveNumber;
+    static constexpr uint8_t WHITE_KINGSIDE = 1;
+    static constexpr uint8_t WHITE_QUEENSIDE = 2;
+    static constexpr uint8_t BLACK_KINGSIDE = 4;
+    static constexpr uint8_t BLACK_QUEENSIDE = 8;
+    static constexpr uint8_t ALL_CASTLING_RIGHTS = WHITE_KINGSIDE | WHITE_QUEENSIDE | BLACK_KINGSIDE | BLACK_QUEENSIDE;
+    static constexpr int8_t NO_EN_PASSANT = -1;
+
+    Color sideToMove;
+    uint8_t castlingRights;
+    /**
+     * Index of the en passant target field, (row - 1) * 8 + (col - 1), or NO_EN_PASSANT
+     */
+    int8_t enPassantSquare;
+    uint16_t halfmoveClock;
+    uint16_t fullmoveNumber;
+
+    static GameState initial();
 
-    GameState();
+    bool hasCastlingRight(uint8_t right) const;
 
-    GameState(Player *currentPlayer, bool canWhiteKingsideCastle, bool canWhiteQueensideCastle,
-              bool canBlackKingsideCastle, bool canBlackQueensideCastle, Position *enPassantTargetPosition,
-              int halfmoveClock, int fullmoveNumber);
+    void removeCastlingRight(uint8_t right);
 
-    void update(const Move &move, Pawn *oldEnPassantTarget);
+    std::optional<Position> getEnPassantTarget() const;
 
-    GameState copy(const Game &original, const Game &copied) const;
+    void setEnPassantTarget(const std::optional<Position> &target);
 
+    /**
+     * En passant target field, invalid if there is none
+     */
+    Square getEnPassantSquare() const {
+        return Square(enPassantSquare);
+    }
+
+    /**
+     * Update the clocks, castling rights and clear the en passant target after the move,
+     * the side to move is switched separately
+     */
+    void update(const Move &move);
 };
 
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay trivially copyable");
+static_assert(sizeof(GameState) <= 8, "GameState must stay small");
+
 #endif //CHESS_GAMESTATE_H
@@ -1,20 +1,63 @@
 #include "HistoryManager.h"
 #include "GameState.h"
+#include "Color.h"
 
-HistoryManager::HistoryManager(int movesIntoThePast, const std::vector<HistoryEntry> &history)
+PlyRecord PlyRecord::fromMove(const Move &move, const GameState &state, uint64_t hash) {
+    auto packedMove = move.getFromSquare().getIndex()
+                      | move.getToSquare().getIndex() << 6
+                      | static_cast<int>(move.getPromoteTo()) << 12;
+    auto capturedType = move.isCapture() ? move.getCapturedPiece()->getType() : PieceType::NONE;
+    return {
+            hash,
+            static_cast<uint16_t>(packedMove),
+            static_cast<uint8_t>(capturedType),
+            state.castlingRights,
+            state.enPassantSquare,
+            state.halfmoveClock
+    };
+}
+
+Position PlyRecord::getFrom() const {
+    return Position(Square(move & 0x3F));
+}
+
+Position PlyRecord::getTo() const {
+    return Position(Square((move >> 6) & 0x3F));
+}
+
+PieceType PlyRecord::getPromoteTo() const {
+    return static_cast<PieceType>(move >> 12);
+}
+
+PieceType PlyRecord::getCapturedType() const {
+    return static_cast<PieceType>(capturedType);
+}
+
+GameState PlyRecord::previousState(const GameState &current) const {
+    auto previousSide = (current.sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    return {
+            previousSide,
+            castlingRights,
+            enPassantSquare,
+            halfmoveClock,
+            static_cast<uint16_t>((previousSide == Color::BLACK) ? current.fullmoveNumber - 1 : current.fullmoveNumber)
+    };
+}
+
+HistoryManager::HistoryManager(int movesIntoThePast, const std::vector<PlyRecord> &history)
         : movesIntoThePast(movesIntoThePast), history(history) {}
 
-void HistoryManager::update(const Move &move, const GameState &state) {
+void HistoryManager::update(const Move &move, const GameState &state, uint64_t hash) {
     this->history.erase(this->history.end() - movesIntoThePast, this->history.end());
     this->movesIntoThePast = 0;
-    this->history.push_back({move, state});
+    this->history.push_back(PlyRecord::fromMove(move, state, hash));
 }
 
 int HistoryManager::getMovesIntoThePast() const {
     return movesIntoThePast;
 }
 
-const std::vector<HistoryEntry> &HistoryManager::getHistory() const {
+const std::vector<PlyRecord> &HistoryManager::getHistory() const {
     return history;
 }
 
@@ -22,26 +65,25 @@ void HistoryManager::setMovesIntoThePast(int movesIntoThePast) {
     HistoryManager::movesIntoThePast = movesIntoThePast;
 }
 
-void HistoryManager::setHistory(const std::vector<HistoryEntry> &history) {
+void HistoryManager::setHistory(const std::vector<PlyRecord> &history) {
     HistoryManager::history = history;
 }
 
-bool HistoryManager::canUndoMove() {
-    return (movesIntoThePast < history.size());
+bool HistoryManager::canUndoMove() const {
+    return (static_cast<size_t>(movesIntoThePast) < history.size());
 }
 
-Move HistoryManager::getMoveToUndo() {
-    auto entry = this->history[this->history.size() - 1 - movesIntoThePast];
+const PlyRecord &HistoryManager::getRecordToUndo() {
     movesIntoThePast++;
-    return entry.move;
+    return this->history[this->history.size() - movesIntoThePast];
 }
 
-bool HistoryManager::canRedoMove() {
+bool HistoryManager::canRedoMove() const {
     return (movesIntoThePast > 0);
 }
 
-Move HistoryManager::getMoveToRedo() {
-    auto entry = this->history[this->history.size() - movesIntoThePast];
+const PlyRecord &HistoryManager::getRecordToRedo() {
+    auto &record = this->history[this->history.size() - movesIntoThePast];
     movesIntoThePast--;
-    return entry.move;
+    return record;
 }
@@ -1,39 +1,78 @@
 #ifndef CHESS_HISTORYMANAGER_H
 #define CHESS_HISTORYMANAGER_H
 
+#include <vector>
+#include <cstdint>
 #include "Move.h"
 #include "GameState.h"
 
+/**
+ * Compact record of a single ply - the move packed into 16 bits, the type of the captured piece and the part of
+ * the state before the move which cannot be recomputed when it is undone. The side to move and the fullmove number
+ * follow from the state after the move.
+ */
+struct PlyRecord {
+    /**
+     * Zobrist hash of the position before the move
+     */
+    uint64_t hash;
+    /**
+     * Source field index | target field index << 6 | promotion piece type << 12
+     */
+    uint16_t move;
+    uint8_t capturedType;
+    uint8_t castlingRights;
+    int8_t enPassantSquare;
+    uint16_t halfmoveClock;
 
-struct HistoryEntry {
-    Move move;
-    GameState state;
+    static PlyRecord fromMove(const Move &move, const GameState &state, uint64_t hash);
+
+    Position getFrom() const;
+
+    Position getTo() const;
+
+    PieceType getPromoteTo() const;
+
+    PieceType getCapturedType() const;
+
+    /**
+     * State of the game before the move, given the state after it
+     */
+    GameState previousState(const GameState &current) const;
 };
 
+static_assert(sizeof(PlyRecord) == 16, "PlyRecord must stay 16 bytes large");
+
 class HistoryManager {
 private:
     int movesIntoThePast;
-    std::vector<HistoryEntry> history;
+    std::vector<PlyRecord> history;
 public:
-    explicit HistoryManager(int movesIntoThePast = 0, const std::vector<HistoryEntry> &history = {});
+    explicit HistoryManager(int movesIntoThePast = 0, const std::vector<PlyRecord> &history = {});
 
-    void update(const Move &move, const GameState &state);
+    void update(const Move &move, const GameState &state, uint64_t hash);
 
     int getMovesIntoThePast() const;
 
-    const std::vector<HistoryEntry> &getHistory() const;
+    const std::vector<PlyRecord> &getHistory() const;
 
     void setMovesIntoThePast(int movesIntoThePast);
 
-    void setHistory(const std::vector<HistoryEntry> &history);
+    void setHistory(const std::vector<PlyRecord> &history);
 
-    bool canUndoMove();
+    bool canUndoMove() const;
 
-    bool canRedoMove();
+    bool canRedoMove() const;
 
-    Move getMoveToUndo();
+    /**
+     * Record of the last played move, moves the cursor one ply into the past
+     */
+    const PlyRecord &getRecordToUndo();
 
-    Move getMoveToRedo();
+    /**
+     * Record of the first undone move, moves the cursor one ply forward
+     */
+    const PlyRecord &getRecordToRedo();
 };
 
 
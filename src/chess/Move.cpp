@@ -7,11 +7,12 @@
 
 #include "Move.h"
 #include "pieces/PieceType.h"
+#include "Color.h"
 #include "Game.h"
 #include "Player.h"
 #include "pieces/Pawn.h"
 
-std::map<std::string, PieceType> Move::promotionMapping = {
+const std::map<std::string, PieceType> Move::promotionMapping = {
         {" ", PieceType::NONE},
         {"q", PieceType::QUEEN},
         {"b", PieceType::BISHOP},
@@ -19,18 +20,26 @@ std::map<std::string, PieceType> Move::promotionMapping = {
         {"n", PieceType::KNIGHT},
 };
 
-std::map<PieceType, std::string> Move::reversePromotionMapping = {
+const std::map<PieceType, std::string> Move::reversePromotionMapping = {
         {PieceType::QUEEN,  "q"},
         {PieceType::BISHOP, "b"},
         {PieceType::ROOK,   "r"},
         {PieceType::KNIGHT, "n"},
 };
 
-const Position &Move::getFrom() const {
+Position Move::getFrom() const {
+    return Position(from);
+}
+
+Position Move::getTo() const {
+    return Position(to);
+}
+
+Square Move::getFromSquare() const {
     return from;
 }
 
-const Position &Move::getTo() const {
+Square Move::getToSquare() const {
     return to;
 }
 
@@ -44,7 +53,7 @@ bool Move::isCapture() const {
 
 std::string Move::toString() const {
     if (isCastling()) {
-        if (getTo().getCol() == 3)
+        if (to.getFile() == 2)
             return "O-O-O";
         return "O-O";
     }
@@ -52,14 +61,14 @@ std::string Move::toString() const {
     std::stringstream ss;
     char pieceChar;
     if (movedPiece->getType() == PieceType::PAWN) {
-        pieceChar = (this->isCapture()) ? 'a' + from.getCol() - 1 : '\0';
+        pieceChar = (this->isCapture()) ? 'a' + from.getFile() : '\0';
     } else { pieceChar = movedPiece->getCharacter(); }
 
     if (pieceChar) { ss << pieceChar; }
     if (this->isCapture()) {
         ss << 'x';
     }
-    ss << to.toString();
+    ss << getTo().toString();
 
     return ss.str();
 }
@@ -82,48 +91,59 @@ Piece *Move::getCapturedPiece() const {
 }
 
 bool Move::isDoublePawnMove() const {
-    auto sourceRow = this->getFrom().getRow();
-    auto targetRow = this->getTo().getRow();
     auto type = this->getPiece()->getType();
-    return (type == PieceType::PAWN && abs(sourceRow - targetRow) == 2);
+    return (type == PieceType::PAWN && abs(from.getRank() - to.getRank()) == 2);
 }
 
 std::string Move::toSmithNotation() const {
     std::stringstream ss;
     ss << this->getFrom().toString() << this->getTo().toString();
-    if (this->resultsInPromotion()) {
-        ss << Move::reversePromotionMapping[this->getPromoteTo()];
+    // generated moves of a pawn to the last rank do not have the promotion piece chosen yet
+    if (this->resultsInPromotion() && this->getPromoteTo() != PieceType::NONE) {
+        ss << Move::reversePromotionMapping.at(this->getPromoteTo());
     }
     return ss.str();
 }
 
 bool Move::isCastling() const {
-    if (movedPiece->getType() == PieceType::KING && abs(getTo().getCol() - getFrom().getCol()) == 2)
+    if (movedPiece->getType() == PieceType::KING && abs(to.getFile() - from.getFile()) == 2)
         return true;
     return false;
 }
 
 Move Move::generateCastlingComplement(Piece *castlingRook, bool forReversal = false) {
-    int row = castlingRook->getPosition().getRow();
+    auto rookSquare = castlingRook->getPosition().toSquare();
     if (forReversal) {
-        int fromCol = (castlingRook->getPosition().getCol() == 4) ? 1 : 8;
-        return Move(Position(row, fromCol), castlingRook->getPosition(), castlingRook, nullptr);
+        int fromFile = (rookSquare.getFile() == 3) ? 0 : 7;
+        return {Square::at(rookSquare.getRank(), fromFile), rookSquare, castlingRook};
     } else {
-        int toCol = (castlingRook->getPosition().getCol() == 1) ? 4 : 6;
-        return Move(castlingRook->getPosition(), Position(row, toCol), castlingRook, nullptr);
+        int toFile = (rookSquare.getFile() == 0) ? 3 : 5;
+        return {rookSquare, Square::at(rookSquare.getRank(), toFile), castlingRook};
     }
 }
 
 bool Move::isLongCastle() const {
-    return (isCastling() && getTo().getCol() == 3);
+    return (isCastling() && to.getFile() == 2);
 }
 
 bool Move::resultsInPromotion() const {
     if (getPiece()->getType() != PieceType::PAWN)
         return false;
-    // if a pawn moves "up", it promotes on rank 8, else on rank 1
-    int promotionRankForThisPawn = (dynamic_cast<Pawn *>(getPiece())->getMoveDirection() == 1) ? 8 : 1;
-    return getTo().getRow() == promotionRankForThisPawn;
+    // white pawns move "up" and promote on rank 8, black ones on rank 1
+    int promotionRankForThisPawn = (getPiece()->getColor() == Color::WHITE) ? 7 : 0;
+    return to.getRank() == promotionRankForThisPawn;
+}
+
+std::vector<Move> Move::withPromotionChoices() const {
+    if (!resultsInPromotion()) {
+        return {*this};
+    }
+    std::vector<Move> moves;
+    for (auto piece: {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+        moves.push_back(*this);
+        moves.back().setPromotion(piece);
+    }
+    return moves;
 }
 
 void Move::validateMove() const {
@@ -146,9 +166,14 @@ Move Move::parseSmithNotation(const std::string &moveStr, const Game &game) {
         throw IllegalMoveException("Invalid representation of a move");
     }
 
-    auto promotionType = (moveStr.size() == 5)
-                         ? Move::promotionMapping[moveStr.substr(4, 1)]
-                         : PieceType::NONE;
+    auto promotionType = PieceType::NONE;
+    if (moveStr.size() == 5) {
+        auto promotion = Move::promotionMapping.find(moveStr.substr(4, 1));
+        if (promotion == Move::promotionMapping.end()) {
+            throw IllegalMoveException("Invalid promotion piece");
+        }
+        promotionType = promotion->second;
+    }
 
     Position sourcePosition = Position::fromString(moveStr.substr(0, 2));
     Position targetPosition = Position::fromString(moveStr.substr(2, 2));
@@ -159,14 +184,16 @@ Move Move::parseSmithNotation(const std::string &moveStr, const Game &game) {
 Move Move::fromPositions(const Game &game, Position from, Position to, PieceType promotion) {
     auto enPassantTargetPos = game.getEnPassantTargetPosition();
     auto movedPiece = game.getPiece(from);
-    auto capturedPiece = (enPassantTargetPos != nullptr && (*enPassantTargetPos) == to)
-                         ? dynamic_cast<Piece *>(game.getEnPassantTargetPiece())
-                         : game.getPiece(to);
-
     if (movedPiece == nullptr) {
         throw IllegalMoveException("Cannot move from empty field");
     }
 
+    // only a pawn captures en passant, other pieces may move to the empty target field
+    auto capturedPiece = (enPassantTargetPos.has_value() && (*enPassantTargetPos) == to &&
+                          movedPiece->getType() == PieceType::PAWN)
+                         ? static_cast<Piece *>(game.getEnPassantTargetPiece())
+                         : game.getPiece(to);
+
     return {from, to, movedPiece, capturedPiece, promotion};
 }
 
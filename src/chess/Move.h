@@ -11,7 +11,9 @@
 
 #include <sstream>
 #include <map>
+#include <vector>
 #include "Position.h"
+#include "Square.h"
 #include "pieces/PieceType.h"
 #include "pieces/Piece.h"
 #include "ChessExceptions.h"
@@ -22,45 +24,59 @@ class Piece;
 
 class Move {
 private:
-    Position from;
-    Position to;
+    Square from;
+    Square to;
     Piece *movedPiece;
     Piece *capturedPiece;
     PieceType promoteTo;
 
-    static std::map<std::string, PieceType> promotionMapping;
+    static const std::map<std::string, PieceType> promotionMapping;
 
-    static std::map<PieceType, std::string> reversePromotionMapping;
+    static const std::map<PieceType, std::string> reversePromotionMapping;
 
     void validateMove() const;
 
 public:
     Move(Position from, Position to, Piece *moved, Piece *captured, PieceType promoteTo) :
-            from(from), to(to), movedPiece(moved), capturedPiece(captured), promoteTo(promoteTo) {
+            from(from.toSquare()), to(to.toSquare()),
+            movedPiece(moved), capturedPiece(captured), promoteTo(promoteTo) {
         validateMove();
     };
 
     Move(Position from, Position to, Piece *moved, Piece *captured) :
-            from(from), to(to), movedPiece(moved), capturedPiece(captured), promoteTo(PieceType::NONE) {
+            from(from.toSquare()), to(to.toSquare()),
+            movedPiece(moved), capturedPiece(captured), promoteTo(PieceType::NONE) {
         validateMove();
     };
 
     Move(Position from, Position to, Piece *moved) :
-            from(from), to(to), movedPiece(moved), capturedPiece(nullptr), promoteTo(PieceType::NONE) {};
+            from(from.toSquare()), to(to.toSquare()),
+            movedPiece(moved), capturedPiece(nullptr), promoteTo(PieceType::NONE) {};
 
-    Move(const Move &move) : from(move.getFrom()), to(move.getTo()), movedPiece(move.getPiece()),
+    Move(const Move &move) : from(move.from), to(move.to), movedPiece(move.getPiece()),
                              capturedPiece(move.getCapturedPiece()), promoteTo(move.promoteTo) {
         validateMove();
     };
 
     Move(Position from, Position to, Piece *moved, PieceType promoteTo) :
-            from(from), to(to), movedPiece(moved), capturedPiece(nullptr), promoteTo(promoteTo) {
+            from(from.toSquare()), to(to.toSquare()),
+            movedPiece(moved), capturedPiece(nullptr), promoteTo(promoteTo) {
         validateMove();
     };
 
-    const Position &getFrom() const;
+    /**
+     * Used by the move generator, the squares must be valid
+     */
+    Move(Square from, Square to, Piece *moved, Piece *captured = nullptr) :
+            from(from), to(to), movedPiece(moved), capturedPiece(captured), promoteTo(PieceType::NONE) {};
+
+    Position getFrom() const;
+
+    Position getTo() const;
 
-    const Position &getTo() const;
+    Square getFromSquare() const;
+
+    Square getToSquare() const;
 
     Piece *getPiece() const;
 
@@ -97,6 +113,11 @@ public:
 
     bool resultsInPromotion() const;
 
+    /**
+     * The move with each piece a pawn may promote to, or only the move if it does not result in a promotion
+     */
+    std::vector<Move> withPromotionChoices() const;
+
     void setPromotion(PieceType promoteTo);
 };
 
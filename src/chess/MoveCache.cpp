@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include "MoveCache.h"
+#include "Game.h"
+#include "Board.h"
+#include "Move.h"
+#include "MoveGenerator.h"
+#include "pieces/Piece.h"
+
+MoveCache::MoveCache(size_t capacity) {
+    size_t sets = 1;
+    while (sets * WAYS < capacity) {
+        sets *= 2;
+    }
+    entries = std::make_unique<Entry[]>(sets * WAYS);
+    setMask = sets - 1;
+}
+
+MoveCache::Entry *MoveCache::setOf(uint64_t hash) const {
+    return &entries[(hash & setMask) * WAYS];
+}
+
+int MoveCache::find(uint64_t hash, std::array<uint16_t, MAX_MOVES> &codes) {
+    auto set = setOf(hash);
+    for (size_t way = 0; way < WAYS; way++) {
+        auto &entry = set[way];
+        auto sequence = entry.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || (sequence & 1) || entry.hash.load(std::memory_order_relaxed) != hash) {
+            continue;
+        }
+
+        auto count = std::min<size_t>(entry.count.load(std::memory_order_relaxed), MAX_MOVES);
+        for (size_t word = 0; word < (count + 3) / 4; word++) {
+            auto value = entry.codes[word].load(std::memory_order_relaxed);
+            for (size_t i = 0; i < 4 && word * 4 + i < count; i++) {
+                codes[word * 4 + i] = static_cast<uint16_t>(value >> (16 * i));
+            }
+        }
+        // the codes are valid only if no writer claimed the entry while they were being copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        entry.lastUse.store(clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return static_cast<int>(count);
+    }
+    return -1;
+}
+
+void MoveCache::insert(uint64_t hash, const std::vector<Move> &moves) {
+    if (moves.size() > MAX_MOVES) {
+        return;
+    }
+    auto set = setOf(hash);
+    auto victim = &set[0];
+    for (size_t way = 0; way < WAYS; way++) {
+        auto &entry = set[way];
+        if (entry.hash.load(std::memory_order_relaxed) == hash &&
+            entry.sequence.load(std::memory_order_relaxed) != 0) {
+            // added by another thread in the meantime
+            return;
+        }
+        if (entry.lastUse.load(std::memory_order_relaxed) < victim->lastUse.load(std::memory_order_relaxed)) {
+            victim = &entry;
+        }
+    }
+
+    auto sequence = victim->sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !victim->sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                                     std::memory_order_acquire)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    victim->hash.store(hash, std::memory_order_relaxed);
+    victim->count.store(static_cast<uint32_t>(moves.size()), std::memory_order_relaxed);
+    for (size_t word = 0; word < (moves.size() + 3) / 4; word++) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 4 && word * 4 + i < moves.size(); i++) {
+            const auto &move = moves[word * 4 + i];
+            uint64_t code = move.getFromSquare().getIndex() | move.getToSquare().getIndex() << 6;
+            if (move.isCapture() && move.getCapturedPiece()->getPosition().toSquare() != move.getToSquare()) {
+                code |= EN_PASSANT_FLAG;
+            }
+            value |= code << (16 * i);
+        }
+        victim->codes[word].store(value, std::memory_order_relaxed);
+    }
+    victim->lastUse.store(clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    victim->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void MoveCache::getLegalMoves(const Game &game, std::vector<Move> &moves) {
+    moves.clear();
+    const auto &board = *game.getBoard();
+    const auto &state = game.getGameState();
+    std::array<uint16_t, MAX_MOVES> codes;
+    auto count = find(game.getHash(), codes);
+    for (int i = 0; i < count; i++) {
+        auto from = Square(codes[i] & 63);
+        auto to = Square((codes[i] >> 6) & 63);
+        auto moved = board.getPiece(from);
+        auto captured = (codes[i] & EN_PASSANT_FLAG) ? board.getPiece(Square::at(from.getRank(), to.getFile()))
+                                                     : board.getPiece(to);
+        // a list of another position with the same hash
+        if (moved == nullptr || moved->getColor() != state.sideToMove) {
+            moves.clear();
+            count = -1;
+            break;
+        }
+        moves.emplace_back(from, to, moved, captured);
+    }
+    if (count >= 0) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    MoveGenerator::generateLegalMoves(board, state, moves);
+    insert(game.getHash(), moves);
+}
+
+size_t MoveCache::getCapacity() const {
+    return (setMask + 1) * WAYS;
+}
+
+uint64_t MoveCache::getHits() const {
+    return hits.load(std::memory_order_relaxed);
+}
+
+uint64_t MoveCache::getMisses() const {
+    return misses.load(std::memory_order_relaxed);
+}
+
+MoveCache &MoveCache::shared() {
+    static MoveCache cache;
+    return cache;
+}
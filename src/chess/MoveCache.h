@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_MOVECACHE_H
+#define CHESS_MOVECACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Game;
+class Move;
+
+/**
+ * Bounded cache of the legal moves of positions, keyed by their Zobrist hash, shared by the games of a process.
+ * The moves are stored as 16-bit codes which do not depend on the piece objects, so a list found for one game
+ * is turned into moves of the pieces of another.
+ *
+ * The cache is split into sets of 8 entries by the lowest bits of the hash, the least recently used entry of the set
+ * is replaced. Both finding and adding a list are lock-free - every entry is guarded by a sequence number which
+ * is odd while the entry is being written. A reader which sees it change treats the entry as missing and a writer
+ * which cannot claim an entry skips adding the list.
+ */
+class MoveCache {
+public:
+    static constexpr size_t WAYS = 8;
+    /**
+     * More than the largest number of legal moves in a chess position, 218
+     */
+    static constexpr size_t MAX_MOVES = 220;
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+private:
+    static constexpr uint16_t EN_PASSANT_FLAG = 1 << 12;
+    static constexpr size_t WORDS = (MAX_MOVES + 3) / 4;
+
+    struct Entry {
+        /**
+         * Even when the entry is complete, 0 if it was never written
+         */
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> hash{0};
+        std::atomic<uint64_t> lastUse{0};
+        std::atomic<uint32_t> count{0};
+        /**
+         * Move codes, 4 in a word - source field | target field << 6 | EN_PASSANT_FLAG
+         */
+        std::array<std::atomic<uint64_t>, WORDS> codes{};
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t setMask;
+    std::atomic<uint64_t> clock{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+    Entry *setOf(uint64_t hash) const;
+
+    /**
+     * Copy the codes of the position's list into the array
+     * @return number of moves, or -1 if there is no list
+     */
+    int find(uint64_t hash, std::array<uint16_t, MAX_MOVES> &codes);
+
+    void insert(uint64_t hash, const std::vector<Move> &moves);
+
+public:
+    /**
+     * @param capacity number of lists, rounded up to a power of two sets of 8
+     */
+    explicit MoveCache(size_t capacity = DEFAULT_CAPACITY);
+
+    MoveCache(const MoveCache &) = delete;
+
+    MoveCache &operator=(const MoveCache &) = delete;
+
+    /**
+     * Legal moves of the side to move in the game's current position, in the order of the move generator,
+     * generated and added to the cache if they are not in it
+     */
+    void getLegalMoves(const Game &game, std::vector<Move> &moves);
+
+    size_t getCapacity() const;
+
+    uint64_t getHits() const;
+
+    uint64_t getMisses() const;
+
+    /**
+     * Cache of the process, used by the interfaces
+     */
+    static MoveCache &shared();
+};
+
+
+#endif //CHESS_MOVECACHE_H
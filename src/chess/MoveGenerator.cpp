@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include "MoveGenerator.h"
+#include "AttackTables.h"
+#include "SlidingAttacks.h"
+#include "Board.h"
+#include "GameState.h"
+
+using GenerationType = MoveGenerator::GenerationType;
+
+namespace {
+    constexpr Color opponentOf(Color color) {
+        return (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    }
+
+    /**
+     * Directions, ranks and castling rights of one side, so that the generator instantiated for it has no
+     * branches on the color
+     */
+    template<Color Us>
+    struct Side {
+        static constexpr Color THEM = opponentOf(Us);
+        static constexpr int UP = (Us == Color::WHITE) ? 1 : -1;
+        static constexpr int STARTING_RANK = (Us == Color::WHITE) ? 1 : 6;
+        // en passant target fields are on the 6th rank for white and on the 3rd for black
+        static constexpr int EN_PASSANT_RANK = (Us == Color::WHITE) ? 5 : 2;
+        static constexpr int BACK_RANK = (Us == Color::WHITE) ? 0 : 7;
+        static constexpr uint8_t KINGSIDE = (Us == Color::WHITE) ? GameState::WHITE_KINGSIDE
+                                                                 : GameState::BLACK_KINGSIDE;
+        static constexpr uint8_t QUEENSIDE = (Us == Color::WHITE) ? GameState::WHITE_QUEENSIDE
+                                                                  : GameState::BLACK_QUEENSIDE;
+    };
+
+    /**
+     * Add a move to each of the target fields, which must be empty or hold an opponent's piece
+     */
+    void addMovesTo(const Board &board, Square square, Bitboard targets, std::vector<Move> &moves) {
+        const auto &squares = board.getSquares();
+        auto piece = board.getPiece(square);
+        while (targets) {
+            auto target = popLowestSquare(targets);
+            if (squares[target.getIndex()] == NO_PIECE) {
+                moves.emplace_back(square, target, piece);
+            } else {
+                moves.emplace_back(square, target, piece, board.getPiece(target));
+            }
+        }
+    }
+
+    /**
+     * Pawn moves ending on the target fields. En passant is also added when the captured pawn stands on a target
+     * field, which lets it answer a check given by that pawn.
+     */
+    template<Color Us, GenerationType Type>
+    void addPawnMoves(const Board &board, Square square, Square enPassantSquare, Bitboard targets,
+                      std::vector<Move> &moves) {
+        using S = Side<Us>;
+        const auto &squares = board.getSquares();
+        auto pawn = board.getPiece(square);
+
+        auto singlePush = square.offset(S::UP, 0);
+        if (!singlePush.isValid()) {
+            return;
+        }
+
+        auto attacks = AttackTables::pawnAttacks(Us, square);
+        addMovesTo(board, square, attacks & board.getOccupied(S::THEM) & targets, moves);
+
+        if (Type != GenerationType::QUIETS && enPassantSquare.isValid() &&
+            (attacks & squareBit(enPassantSquare)) && enPassantSquare.getRank() == S::EN_PASSANT_RANK) {
+            auto capturedPawn = Square::at(square.getRank(), enPassantSquare.getFile());
+            if (squares[capturedPawn.getIndex()] == makePieceCode(S::THEM, PieceType::PAWN) &&
+                (targets & (squareBit(enPassantSquare) | squareBit(capturedPawn)))) {
+                moves.emplace_back(square, enPassantSquare, pawn, board.getPiece(capturedPawn));
+            }
+        }
+
+        if (Type == GenerationType::CAPTURES || squares[singlePush.getIndex()] != NO_PIECE) {
+            return;
+        }
+        if (targets & squareBit(singlePush)) {
+            moves.emplace_back(square, singlePush, pawn);
+        }
+        auto doublePush = singlePush.offset(S::UP, 0);
+        if (square.getRank() == S::STARTING_RANK && squares[doublePush.getIndex()] == NO_PIECE &&
+            (targets & squareBit(doublePush))) {
+            moves.emplace_back(square, doublePush, pawn);
+        }
+    }
+
+    template<Color Us, GenerationType Type>
+    void addPieceMoves(const Board &board, Square square, Square enPassantSquare, Bitboard targets,
+                       std::vector<Move> &moves) {
+        auto occupied = board.getOccupied();
+        switch (pieceTypeOf(board.getSquares()[square.getIndex()])) {
+            case PieceType::PAWN:
+                addPawnMoves<Us, Type>(board, square, enPassantSquare, targets, moves);
+                break;
+            case PieceType::KNIGHT:
+                addMovesTo(board, square, AttackTables::knightAttacks(square) & targets, moves);
+                break;
+            case PieceType::BISHOP:
+                addMovesTo(board, square, SlidingAttacks::bishopAttacks(square, occupied) & targets, moves);
+                break;
+            case PieceType::ROOK:
+                addMovesTo(board, square, SlidingAttacks::rookAttacks(square, occupied) & targets, moves);
+                break;
+            case PieceType::QUEEN:
+                addMovesTo(board, square, SlidingAttacks::queenAttacks(square, occupied) & targets, moves);
+                break;
+            case PieceType::KING:
+                addMovesTo(board, square, AttackTables::kingAttacks(square) & targets, moves);
+                break;
+            case PieceType::NONE:
+                break;
+        }
+    }
+
+    /**
+     * Castling moves allowed by the castling rights with no pieces between the king and the rook, not taking
+     * attacked fields into account
+     */
+    template<Color Us>
+    bool canCastle(const Board &board, const GameState &state, bool kingside) {
+        using S = Side<Us>;
+        constexpr auto king = Square::at(S::BACK_RANK, 4);
+        auto rook = Square::at(S::BACK_RANK, kingside ? 7 : 0);
+        const auto &squares = board.getSquares();
+        // the rights are not trusted to match the pieces, e.g. in a Game built directly from a CompactPosition
+        return state.hasCastlingRight(kingside ? S::KINGSIDE : S::QUEENSIDE) &&
+               squares[king.getIndex()] == makePieceCode(Us, PieceType::KING) &&
+               squares[rook.getIndex()] == makePieceCode(Us, PieceType::ROOK) &&
+               !(board.getOccupied() & AttackTables::between(king, rook));
+    }
+
+    template<Color Us>
+    void addCastlingMoves(const Board &board, const GameState &state, std::vector<Move> &moves) {
+        using S = Side<Us>;
+        constexpr auto king = Square::at(S::BACK_RANK, 4);
+        if (canCastle<Us>(board, state, true)) {
+            moves.emplace_back(king, Square::at(S::BACK_RANK, 6), board.getPiece(king));
+        }
+        if (canCastle<Us>(board, state, false)) {
+            moves.emplace_back(king, Square::at(S::BACK_RANK, 2), board.getPiece(king));
+        }
+    }
+
+    /**
+     * Whether any of the fields in origins holds the attacker
+     */
+    bool isAttackedFrom(const BoardSquares &squares, Bitboard origins, PieceCode attacker) {
+        while (origins) {
+            if (squares[popLowestSquare(origins).getIndex()] == attacker) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Bitboard attackersOf(const BoardSquares &squares, Bitboard occupied, Square square, Color attackerColor) {
+        auto matching = [&squares](Bitboard origins, PieceCode first, PieceCode second) {
+            Bitboard found = 0;
+            while (origins) {
+                auto origin = popLowestSquare(origins);
+                auto code = squares[origin.getIndex()];
+                if (code == first || code == second) {
+                    found |= squareBit(origin);
+                }
+            }
+            return found;
+        };
+        auto queen = makePieceCode(attackerColor, PieceType::QUEEN);
+        auto pawn = makePieceCode(attackerColor, PieceType::PAWN);
+        auto knight = makePieceCode(attackerColor, PieceType::KNIGHT);
+        return matching(AttackTables::pawnAttacks(opponentOf(attackerColor), square), pawn, pawn) |
+               matching(AttackTables::knightAttacks(square), knight, knight) |
+               matching(SlidingAttacks::rookAttacks(square, occupied) & occupied,
+                        makePieceCode(attackerColor, PieceType::ROOK), queen) |
+               matching(SlidingAttacks::bishopAttacks(square, occupied) & occupied,
+                        makePieceCode(attackerColor, PieceType::BISHOP), queen);
+    }
+
+    template<Color Us, GenerationType Type>
+    void generate(const Board &board, const GameState &state, std::vector<Move> &moves) {
+        auto own = board.getOccupied(Us);
+        auto king = Square();
+        for (auto pieces = own; pieces;) {
+            auto square = popLowestSquare(pieces);
+            if (board.getSquares()[square.getIndex()] == makePieceCode(Us, PieceType::KING)) {
+                king = square;
+                break;
+            }
+        }
+
+        Bitboard targets = (Type == GenerationType::CAPTURES) ? board.getOccupied(Side<Us>::THEM)
+                           : (Type == GenerationType::QUIETS) ? ~board.getOccupied()
+                           : ~own;
+        Bitboard kingTargets = targets;
+        if (Type == GenerationType::EVASIONS && king.isValid()) {
+            auto checkers = attackersOf(board.getSquares(), board.getOccupied(), king, Side<Us>::THEM);
+            if (checkers & (checkers - 1)) {
+                // only the king can answer a double check
+                targets = 0;
+            } else if (checkers) {
+                auto checker = popLowestSquare(checkers);
+                targets &= squareBit(checker) | AttackTables::between(king, checker);
+            }
+        }
+
+        auto enPassantSquare = state.getEnPassantSquare();
+        for (auto pieces = own; pieces;) {
+            auto square = popLowestSquare(pieces);
+            addPieceMoves<Us, Type>(board, square, enPassantSquare, (square == king) ? kingTargets : targets, moves);
+        }
+        if (Type == GenerationType::QUIETS || Type == GenerationType::NON_EVASIONS) {
+            addCastlingMoves<Us>(board, state, moves);
+        }
+    }
+
+    template<Color Us>
+    void generate(GenerationType type, const Board &board, const GameState &state, std::vector<Move> &moves) {
+        switch (type) {
+            case GenerationType::CAPTURES:
+                generate<Us, GenerationType::CAPTURES>(board, state, moves);
+                break;
+            case GenerationType::QUIETS:
+                generate<Us, GenerationType::QUIETS>(board, state, moves);
+                break;
+            case GenerationType::EVASIONS:
+                generate<Us, GenerationType::EVASIONS>(board, state, moves);
+                break;
+            case GenerationType::NON_EVASIONS:
+                generate<Us, GenerationType::NON_EVASIONS>(board, state, moves);
+                break;
+        }
+    }
+
+    bool isCastlingMove(PieceCode code, const Move &move) {
+        return pieceTypeOf(code) == PieceType::KING &&
+               abs(move.getToSquare().getFile() - move.getFromSquare().getFile()) == 2;
+    }
+
+    /**
+     * Whether addCastlingMoves would add the castling move of the king
+     */
+    template<Color Us>
+    bool isPseudoLegalCastling(const Board &board, const GameState &state, const Move &move) {
+        using S = Side<Us>;
+        constexpr auto king = Square::at(S::BACK_RANK, 4);
+        auto to = move.getToSquare();
+        if (move.getFromSquare() != king || to.getRank() != S::BACK_RANK || move.getCapturedPiece() != nullptr) {
+            return false;
+        }
+        return canCastle<Us>(board, state, to.getFile() == 6);
+    }
+
+    /**
+     * Whether addPieceMoves or addCastlingMoves would add the move, the moved piece belongs to the side to move
+     */
+    template<Color Us>
+    bool isPseudoLegalFor(const Board &board, const GameState &state, const Move &move) {
+        using S = Side<Us>;
+        const auto &squares = board.getSquares();
+        auto from = move.getFromSquare();
+        auto to = move.getToSquare();
+        auto code = squares[from.getIndex()];
+        if (board.getOccupied(Us) & squareBit(to)) {
+            return false;
+        }
+
+        auto occupied = board.getOccupied();
+        Bitboard targets = 0;
+        switch (pieceTypeOf(code)) {
+            case PieceType::PAWN: {
+                auto singlePush = from.offset(S::UP, 0);
+                if (!singlePush.isValid()) {
+                    return false;
+                }
+                auto attacks = AttackTables::pawnAttacks(Us, from);
+                auto enPassantSquare = state.getEnPassantSquare();
+                if (to == enPassantSquare && (attacks & squareBit(to)) && to.getRank() == S::EN_PASSANT_RANK &&
+                    squares[to.getIndex()] == NO_PIECE) {
+                    auto capturedPawn = Square::at(from.getRank(), to.getFile());
+                    return squares[capturedPawn.getIndex()] == makePieceCode(S::THEM, PieceType::PAWN) &&
+                           move.getCapturedPiece() == board.getPiece(capturedPawn);
+                }
+                targets = attacks & board.getOccupied(S::THEM);
+                if (squares[singlePush.getIndex()] == NO_PIECE) {
+                    targets |= squareBit(singlePush);
+                    auto doublePush = singlePush.offset(S::UP, 0);
+                    if (from.getRank() == S::STARTING_RANK && squares[doublePush.getIndex()] == NO_PIECE) {
+                        targets |= squareBit(doublePush);
+                    }
+                }
+                break;
+            }
+            case PieceType::KNIGHT:
+                targets = AttackTables::knightAttacks(from);
+                break;
+            case PieceType::BISHOP:
+                targets = SlidingAttacks::bishopAttacks(from, occupied);
+                break;
+            case PieceType::ROOK:
+                targets = SlidingAttacks::rookAttacks(from, occupied);
+                break;
+            case PieceType::QUEEN:
+                targets = SlidingAttacks::queenAttacks(from, occupied);
+                break;
+            case PieceType::KING:
+                if (isCastlingMove(code, move)) {
+                    return isPseudoLegalCastling<Us>(board, state, move);
+                }
+                targets = AttackTables::kingAttacks(from);
+                break;
+            case PieceType::NONE:
+                return false;
+        }
+        return (targets & squareBit(to)) && move.getCapturedPiece() == board.getPiece(to);
+    }
+}
+
+void MoveGenerator::generatePieceMoves(const Board &board, Square square, Square enPassantSquare,
+                                       std::vector<Move> &moves) {
+    auto code = board.getSquares()[square.getIndex()];
+    if (code == NO_PIECE) {
+        return;
+    }
+    auto color = pieceColorOf(code);
+    if (color == Color::WHITE) {
+        addPieceMoves<Color::WHITE, GenerationType::NON_EVASIONS>(board, square, enPassantSquare,
+                                                                  ~board.getOccupied(color), moves);
+    } else {
+        addPieceMoves<Color::BLACK, GenerationType::NON_EVASIONS>(board, square, enPassantSquare,
+                                                                  ~board.getOccupied(color), moves);
+    }
+}
+
+void MoveGenerator::generateCastlingMoves(const Board &board, const GameState &state, std::vector<Move> &moves) {
+    if (state.sideToMove == Color::WHITE) {
+        addCastlingMoves<Color::WHITE>(board, state, moves);
+    } else {
+        addCastlingMoves<Color::BLACK>(board, state, moves);
+    }
+}
+
+void MoveGenerator::generateMoves(GenerationType type, const Board &board, const GameState &state,
+                                  std::vector<Move> &moves) {
+    if (state.sideToMove == Color::WHITE) {
+        generate<Color::WHITE>(type, board, state, moves);
+    } else {
+        generate<Color::BLACK>(type, board, state, moves);
+    }
+}
+
+void MoveGenerator::generateLegalMoves(const Board &board, const GameState &state, std::vector<Move> &moves) {
+    auto first = moves.size();
+    auto inCheck = isKingAttacked(board.getSquares(), board.getOccupied(), state.sideToMove);
+    generateMoves(inCheck ? GenerationType::EVASIONS : GenerationType::NON_EVASIONS, board, state, moves);
+    moves.erase(std::remove_if(moves.begin() + static_cast<std::ptrdiff_t>(first), moves.end(),
+                               [&board, &state](const Move &move) { return !isLegal(board, state, move); }),
+                moves.end());
+}
+
+bool MoveGenerator::isPseudoLegal(const Board &board, const GameState &state, const Move &move) {
+    auto from = move.getFromSquare();
+    auto code = board.getSquares()[from.getIndex()];
+    if (code == NO_PIECE || pieceColorOf(code) != state.sideToMove || move.getPiece() != board.getPiece(from)) {
+        return false;
+    }
+
+    auto promotion = move.getPromoteTo();
+    if (promotion != PieceType::NONE) {
+        auto lastRank = (state.sideToMove == Color::WHITE) ? 7 : 0;
+        if (pieceTypeOf(code) != PieceType::PAWN || move.getToSquare().getRank() != lastRank ||
+            promotion == PieceType::PAWN || promotion == PieceType::KING) {
+            return false;
+        }
+    }
+
+    return (state.sideToMove == Color::WHITE) ? isPseudoLegalFor<Color::WHITE>(board, state, move)
+                                              : isPseudoLegalFor<Color::BLACK>(board, state, move);
+}
+
+bool MoveGenerator::isLegal(const Board &board, const GameState &state, const Move &move) {
+    const auto &squares = board.getSquares();
+    auto from = move.getFromSquare();
+    auto code = squares[from.getIndex()];
+    if (isCastlingMove(code, move)) {
+        // the king may not castle out of or through check, the target field is checked like for other moves
+        auto passedSquare = Square::at(from.getRank(), (from.getFile() + move.getToSquare().getFile()) / 2);
+        auto opponent = opponentOf(pieceColorOf(code));
+        if (isSquareAttacked(squares, board.getOccupied(), from, opponent) ||
+            isSquareAttacked(squares, board.getOccupied(), passedSquare, opponent)) {
+            return false;
+        }
+    }
+    return !leavesKingAttacked(squares, board.getOccupied(), move, state.getEnPassantSquare());
+}
+
+bool MoveGenerator::isSquareAttacked(const BoardSquares &squares, Bitboard occupied, Square square,
+                                     Color attackerColor) {
+    // a pawn attacks the field if a pawn of the other color standing there would attack the pawn
+    auto pawnOrigins = AttackTables::pawnAttacks(opponentOf(attackerColor), square);
+    if (isAttackedFrom(squares, pawnOrigins, makePieceCode(attackerColor, PieceType::PAWN)) ||
+        isAttackedFrom(squares, AttackTables::knightAttacks(square), makePieceCode(attackerColor, PieceType::KNIGHT)) ||
+        isAttackedFrom(squares, AttackTables::kingAttacks(square), makePieceCode(attackerColor, PieceType::KING))) {
+        return true;
+    }
+
+    // only the first piece in each direction can attack the field
+    auto queen = makePieceCode(attackerColor, PieceType::QUEEN);
+    auto rook = makePieceCode(attackerColor, PieceType::ROOK);
+    auto bishop = makePieceCode(attackerColor, PieceType::BISHOP);
+    auto blockers = SlidingAttacks::rookAttacks(square, occupied) & occupied;
+    while (blockers) {
+        auto code = squares[popLowestSquare(blockers).getIndex()];
+        if (code == rook || code == queen) {
+            return true;
+        }
+    }
+    blockers = SlidingAttacks::bishopAttacks(square, occupied) & occupied;
+    while (blockers) {
+        auto code = squares[popLowestSquare(blockers).getIndex()];
+        if (code == bishop || code == queen) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MoveGenerator::isKingAttacked(const BoardSquares &squares, Bitboard occupied, Color kingColor) {
+    auto king = makePieceCode(kingColor, PieceType::KING);
+    for (auto pieces = occupied; pieces;) {
+        auto square = popLowestSquare(pieces);
+        if (squares[square.getIndex()] == king) {
+            return isSquareAttacked(squares, occupied, square, opponentOf(kingColor));
+        }
+    }
+    return false;
+}
+
+bool MoveGenerator::leavesKingAttacked(const BoardSquares &squares, Bitboard occupied, const Move &move,
+                                       Square enPassantSquare) {
+    BoardSquares after = squares;
+    auto from = move.getFromSquare();
+    auto to = move.getToSquare();
+    auto code = after[from.getIndex()];
+
+    if (pieceTypeOf(code) == PieceType::PAWN && to == enPassantSquare && after[to.getIndex()] == NO_PIECE) {
+        auto capturedPawn = Square::at(from.getRank(), to.getFile());
+        after[capturedPawn.getIndex()] = NO_PIECE;
+        occupied &= ~squareBit(capturedPawn);
+    }
+    if (isCastlingMove(code, move)) {
+        auto rookFrom = Square::at(from.getRank(), (to.getFile() > from.getFile()) ? 7 : 0);
+        auto rookTo = Square::at(from.getRank(), (from.getFile() + to.getFile()) / 2);
+        after[rookTo.getIndex()] = after[rookFrom.getIndex()];
+        after[rookFrom.getIndex()] = NO_PIECE;
+        occupied = (occupied & ~squareBit(rookFrom)) | squareBit(rookTo);
+    }
+    after[to.getIndex()] = (move.getPromoteTo() != PieceType::NONE)
+                           ? makePieceCode(pieceColorOf(code), move.getPromoteTo())
+                           : code;
+    after[from.getIndex()] = NO_PIECE;
+    occupied = (occupied & ~squareBit(from)) | squareBit(to);
+    return isKingAttacked(after, occupied, pieceColorOf(code));
+}
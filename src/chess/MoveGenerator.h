@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_MOVEGENERATOR_H
+#define CHESS_MOVEGENERATOR_H
+
+#include <vector>
+#include "PieceCode.h"
+#include "Square.h"
+#include "Bitboard.h"
+#include "Move.h"
+
+class Board;
+
+struct GameState;
+
+/**
+ * Move generation working on the piece codes of the board instead of the piece objects. Pieces are dispatched
+ * by a switch on their type, the objects are only looked up to fill in the generated Move objects.
+ * Knight, king and pawn attacks are looked up in the precomputed AttackTables, sliding attacks in SlidingAttacks.
+ * The queries take the set of occupied fields alongside the piece codes.
+ */
+class MoveGenerator {
+public:
+    /**
+     * Kinds of moves generated for the side to move. The generator is instantiated for each kind and color,
+     * so that the checks of both are resolved at compile time.
+     */
+    enum class GenerationType : uint8_t {
+        CAPTURES,
+        /**
+         * Moves which do not capture, including castling and promotions without a capture
+         */
+        QUIETS,
+        /**
+         * Moves which may answer a check - king moves, captures of the checking piece and blocks
+         */
+        EVASIONS,
+        /**
+         * Captures and quiets, for positions without a check
+         */
+        NON_EVASIONS,
+    };
+
+    /**
+     * Append the pseudo-legal moves of the given kind for the side to move - pins and attacked fields are not
+     * taken into account. The order of the moves is unspecified.
+     */
+    static void generateMoves(GenerationType type, const Board &board, const GameState &state,
+                              std::vector<Move> &moves);
+
+    /**
+     * Append the legal moves of the side to move
+     */
+    static void generateLegalMoves(const Board &board, const GameState &state, std::vector<Move> &moves);
+
+    /**
+     * Whether the move is one the generator could return for the side to move, checked on the attack tables without
+     * generating the other moves. The moved and captured pieces of the move must be the ones on the board.
+     * Pins and attacked fields are not taken into account.
+     */
+    static bool isPseudoLegal(const Board &board, const GameState &state, const Move &move);
+
+    /**
+     * Whether a pseudo-legal move of the side to move does not leave its king attacked and does not castle out of
+     * or through a check
+     */
+    static bool isLegal(const Board &board, const GameState &state, const Move &move);
+
+    /**
+     * Append the moves of the piece on the given field to moves, not taking checks, pins and castling into account.
+     * The order of the moves is unspecified - archives sort the legal moves before indexing them.
+     *
+     * @param enPassantSquare en passant target field, invalid if there is none
+     */
+    static void generatePieceMoves(const Board &board, Square square, Square enPassantSquare, std::vector<Move> &moves);
+
+    /**
+     * Append the castling moves of the side to move allowed by the castling rights, with the king and the rook
+     * on their initial fields and no pieces between them. Attacked fields are not taken into account.
+     */
+    static void generateCastlingMoves(const Board &board, const GameState &state, std::vector<Move> &moves);
+
+    static bool isSquareAttacked(const BoardSquares &squares, Bitboard occupied, Square square, Color attackerColor);
+
+    /**
+     * Whether the king of the given color is attacked, false if there is no such king on the board
+     */
+    static bool isKingAttacked(const BoardSquares &squares, Bitboard occupied, Color kingColor);
+
+    /**
+     * Whether the move would leave the king of the moving side attacked, checked on a copy of the piece codes
+     */
+    static bool leavesKingAttacked(const BoardSquares &squares, Bitboard occupied, const Move &move,
+                                   Square enPassantSquare);
+};
+
+
+#endif //CHESS_MOVEGENERATOR_H
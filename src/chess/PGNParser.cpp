@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include "PGNParser.h"
+#include "FENParser.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "Color.h"
+#include "ChessExceptions.h"
+#include "pieces/Piece.h"
+#include "pieces/PieceType.h"
+
+namespace {
+    bool isTerminationMarker(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    bool isTokenDelimiter(char character) {
+        return isspace(character) || character == '{' || character == '}' || character == '(' ||
+               character == ')' || character == ';' || character == '[' || character == ']';
+    }
+
+    size_t skipToEndOfLine(std::string_view text, size_t offset) {
+        auto end = text.find('\n', offset);
+        return (end == std::string_view::npos) ? text.size() : end + 1;
+    }
+
+    PieceType pieceTypeFromLetter(char letter) {
+        switch (letter) {
+            case 'K':
+                return PieceType::KING;
+            case 'Q':
+                return PieceType::QUEEN;
+            case 'R':
+                return PieceType::ROOK;
+            case 'B':
+                return PieceType::BISHOP;
+            case 'N':
+                return PieceType::KNIGHT;
+            default:
+                throw IllegalMoveException(std::string("Invalid piece letter ") + letter);
+        }
+    }
+
+    char letterFromPieceType(PieceType type) {
+        switch (type) {
+            case PieceType::KING:
+                return 'K';
+            case PieceType::QUEEN:
+                return 'Q';
+            case PieceType::ROOK:
+                return 'R';
+            case PieceType::BISHOP:
+                return 'B';
+            case PieceType::KNIGHT:
+                return 'N';
+            default:
+                return '\0';
+        }
+    }
+}
+
+std::string PgnGame::getTag(const std::string &name) const {
+    for (const auto &tag: tags) {
+        if (tag.first == name) {
+            return tag.second;
+        }
+    }
+    return "";
+}
+
+bool PgnGame::hasTag(const std::string &name) const {
+    return std::any_of(tags.begin(), tags.end(), [&name](const std::pair<std::string, std::string> &tag) {
+        return tag.first == name;
+    });
+}
+
+std::vector<std::string_view> PGNParser::splitGames(std::string_view pgn) {
+    std::vector<std::string_view> games;
+    size_t gameStart = std::string_view::npos;
+    bool inMovetext = false;
+
+    size_t lineStart = 0;
+    while (lineStart < pgn.size()) {
+        auto lineEnd = skipToEndOfLine(pgn, lineStart);
+        auto firstChar = pgn.find_first_not_of(" \t\r", lineStart);
+        bool isBlank = (firstChar == std::string_view::npos || firstChar >= lineEnd || pgn[firstChar] == '\n');
+
+        if (!isBlank && pgn[lineStart] != '%') {
+            if (pgn[firstChar] == '[') {
+                if (gameStart != std::string_view::npos && inMovetext) {
+                    games.push_back(pgn.substr(gameStart, lineStart - gameStart));
+                    gameStart = std::string_view::npos;
+                }
+                inMovetext = false;
+            } else {
+                inMovetext = true;
+            }
+
+            if (gameStart == std::string_view::npos) {
+                gameStart = lineStart;
+            }
+        }
+        lineStart = lineEnd;
+    }
+
+    if (gameStart != std::string_view::npos) {
+        games.push_back(pgn.substr(gameStart));
+    }
+    return games;
+}
+
+std::pair<std::string, std::string> PGNParser::parseTag(std::string_view pgn, size_t &offset) {
+    // skip the opening bracket
+    offset++;
+    while (offset < pgn.size() && isblank(pgn[offset])) {
+        offset++;
+    }
+
+    std::string name;
+    while (offset < pgn.size() && (isalnum(pgn[offset]) || pgn[offset] == '_')) {
+        name += pgn[offset++];
+    }
+    while (offset < pgn.size() && isblank(pgn[offset])) {
+        offset++;
+    }
+
+    if (name.empty() || offset >= pgn.size() || pgn[offset] != '"') {
+        throw PgnException("Invalid PGN tag pair");
+    }
+    offset++;
+
+    std::string value;
+    while (offset < pgn.size() && pgn[offset] != '"') {
+        if (pgn[offset] == '\n') {
+            throw PgnException("Unterminated value of PGN tag " + name);
+        }
+        if (pgn[offset] == '\\' && offset + 1 < pgn.size()) {
+            offset++;
+        }
+        value += pgn[offset++];
+    }
+    if (offset >= pgn.size()) {
+        throw PgnException("Unterminated value of PGN tag " + name);
+    }
+    offset++;
+
+    while (offset < pgn.size() && isblank(pgn[offset])) {
+        offset++;
+    }
+    if (offset >= pgn.size() || pgn[offset] != ']') {
+        throw PgnException("Missing closing bracket of PGN tag " + name);
+    }
+    offset++;
+
+    return {name, value};
+}
+
+PgnGame PGNParser::parseGame(std::string_view pgn) {
+    PgnGame game;
+    size_t offset = 0;
+
+    while (offset < pgn.size()) {
+        auto character = pgn[offset];
+        bool atLineStart = (offset == 0 || pgn[offset - 1] == '\n');
+
+        if (isspace(character)) {
+            offset++;
+        } else if (character == '%' && atLineStart) {
+            offset = skipToEndOfLine(pgn, offset);
+        } else if (character == ';') {
+            offset = skipToEndOfLine(pgn, offset);
+        } else if (character == '[') {
+            if (!game.moves.empty() || !game.result.empty()) {
+                throw PgnException("Tag pair inside movetext");
+            }
+            game.tags.push_back(parseTag(pgn, offset));
+        } else if (character == '{') {
+            auto commentEnd = pgn.find('}', offset);
+            if (commentEnd == std::string_view::npos) {
+                throw PgnException("Unterminated comment");
+            }
+            offset = commentEnd + 1;
+        } else if (character == '(') {
+            // variations are skipped along with everything nested inside them
+            int depth = 0;
+            do {
+                if (offset >= pgn.size()) {
+                    throw PgnException("Unterminated variation");
+                }
+                if (pgn[offset] == '{') {
+                    offset = pgn.find('}', offset);
+                    if (offset == std::string_view::npos) {
+                        throw PgnException("Unterminated comment");
+                    }
+                } else if (pgn[offset] == ';') {
+                    offset = skipToEndOfLine(pgn, offset) - 1;
+                } else if (pgn[offset] == '(') {
+                    depth++;
+                } else if (pgn[offset] == ')') {
+                    depth--;
+                }
+                offset++;
+            } while (depth > 0);
+        } else if (character == ')' || character == ']' || character == '}') {
+            throw PgnException(std::string("Unexpected character ") + character);
+        } else if (character == '$') {
+            // numeric annotation glyph
+            offset++;
+            while (offset < pgn.size() && isdigit(pgn[offset])) {
+                offset++;
+            }
+        } else {
+            auto tokenStart = offset;
+            while (offset < pgn.size() && !isTokenDelimiter(pgn[offset])) {
+                offset++;
+            }
+            auto token = pgn.substr(tokenStart, offset - tokenStart);
+
+            if (isTerminationMarker(token)) {
+                if (!game.result.empty()) {
+                    throw PgnException("Multiple game termination markers");
+                }
+                game.result = std::string(token);
+                continue;
+            }
+
+            // strip the move number indication, eg. "12." or "12..." possibly glued to the move
+            auto numberEnd = token.find_first_not_of("0123456789");
+            if (numberEnd != std::string_view::npos && numberEnd > 0 && token[numberEnd] == '.') {
+                token.remove_prefix(numberEnd);
+            } else if (numberEnd == std::string_view::npos) {
+                throw PgnException("Unexpected token " + std::string(token));
+            }
+            while (!token.empty() && token.front() == '.') {
+                token.remove_prefix(1);
+            }
+            // strip suffix annotations, eg. "!?"
+            while (!token.empty() && (token.back() == '!' || token.back() == '?')) {
+                token.remove_suffix(1);
+            }
+            if (token.empty()) {
+                continue;
+            }
+
+            if (!game.result.empty()) {
+                throw PgnException("Move " + std::string(token) + " after game termination marker");
+            }
+            game.moves.emplace_back(token);
+        }
+    }
+
+    return game;
+}
+
+std::vector<PgnGame> PGNParser::parseGames(std::string_view pgn) {
+    std::vector<PgnGame> games;
+    for (auto gameText: PGNParser::splitGames(pgn)) {
+        games.push_back(PGNParser::parseGame(gameText));
+    }
+    return games;
+}
+
+Game PGNParser::initialGame(const PgnGame &pgnGame) {
+    if (pgnGame.hasTag("FEN")) {
+        return FENParser::parseGame(pgnGame.getTag("FEN"));
+    }
+    return {};
+}
+
+Move PGNParser::parseSan(const std::string &san, const Game &game) {
+    std::string notation = san;
+    while (!notation.empty() && (notation.back() == '+' || notation.back() == '#')) {
+        notation.pop_back();
+    }
+    if (notation.empty()) {
+        throw IllegalMoveException("Empty move");
+    }
+
+    auto player = game.getCurrentPlayer();
+    int backRank = (player->getColor() == Color::WHITE) ? 1 : 8;
+
+    if (notation == "O-O" || notation == "0-0" || notation == "O-O-O" || notation == "0-0-0") {
+        int targetCol = (notation.size() == 3) ? 7 : 3;
+        for (const auto &move: game.getLegalMovesFrom(Position(backRank, 5))) {
+            if (move.isCastling() && move.getTo().getCol() == targetCol) {
+                return move;
+            }
+        }
+        throw IllegalMoveException("Illegal move " + san);
+    }
+
+    auto promoteTo = PieceType::NONE;
+    auto promotionSign = notation.find('=');
+    if (promotionSign != std::string::npos) {
+        if (promotionSign + 2 != notation.size()) {
+            throw IllegalMoveException("Invalid promotion in move " + san);
+        }
+        promoteTo = pieceTypeFromLetter(notation.back());
+        notation.erase(promotionSign);
+    } else if (notation.size() >= 3 && isupper(notation.back()) && isdigit(notation[notation.size() - 2])) {
+        promoteTo = pieceTypeFromLetter(notation.back());
+        notation.pop_back();
+    }
+
+    auto movedType = PieceType::PAWN;
+    size_t qualifierStart = 0;
+    if (isupper(notation[0])) {
+        movedType = pieceTypeFromLetter(notation[0]);
+        qualifierStart = 1;
+    }
+    if (notation.size() < qualifierStart + 2 || promoteTo == PieceType::KING ||
+        (promoteTo != PieceType::NONE && movedType != PieceType::PAWN)) {
+        throw IllegalMoveException("Invalid representation of move " + san);
+    }
+
+    auto targetString = notation.substr(notation.size() - 2);
+    if (targetString[0] < 'a' || targetString[0] > 'h' || targetString[1] < '1' || targetString[1] > '8') {
+        throw IllegalMoveException("Invalid target square in move " + san);
+    }
+    auto target = Position::fromString(targetString);
+
+    int fromCol = 0;
+    int fromRow = 0;
+    for (auto character: notation.substr(qualifierStart, notation.size() - 2 - qualifierStart)) {
+        if (character >= 'a' && character <= 'h') {
+            fromCol = character - 'a' + 1;
+        } else if (character >= '1' && character <= '8') {
+            fromRow = character - '0';
+        } else if (character != 'x' && character != '-') {
+            throw IllegalMoveException("Invalid representation of move " + san);
+        }
+    }
+
+    std::vector<Move> matchingMoves;
+    auto pieces = std::vector<Piece *>(player->getPieces());
+    for (auto piece: pieces) {
+        auto from = piece->getPosition();
+        if (piece->getType() != movedType ||
+            (fromCol != 0 && from.getCol() != fromCol) ||
+            (fromRow != 0 && from.getRow() != fromRow)) {
+            continue;
+        }
+
+        // check legality only for the pieces which can reach the target at all
+        auto possibleMoves = game.getMovesFrom(from);
+        if (std::none_of(possibleMoves.begin(), possibleMoves.end(), [target](const Move &move) {
+            return move.getTo() == target && !move.isCastling();
+        })) {
+            continue;
+        }
+
+        for (const auto &move: game.getLegalMovesFrom(from)) {
+            if (move.getTo() == target && !move.isCastling()) {
+                matchingMoves.push_back(move);
+            }
+        }
+    }
+
+    if (matchingMoves.empty()) {
+        throw IllegalMoveException("Illegal move " + san);
+    }
+    if (matchingMoves.size() > 1) {
+        throw IllegalMoveException("Ambiguous move " + san);
+    }
+
+    auto &move = matchingMoves[0];
+    if (move.resultsInPromotion() && promoteTo == PieceType::NONE) {
+        throw IllegalMoveException("Missing promotion piece in move " + san);
+    }
+    if (!move.resultsInPromotion() && promoteTo != PieceType::NONE) {
+        throw IllegalMoveException("Move " + san + " does not result in promotion");
+    }
+
+    return {move.getFrom(), move.getTo(), move.getPiece(), move.getCapturedPiece(), promoteTo};
+}
+
+std::string PGNParser::moveToSan(const Move &move, const Game &game) {
+    std::stringstream ss;
+    auto movedPiece = move.getPiece();
+
+    if (move.isCastling()) {
+        ss << (move.isLongCastle() ? "O-O-O" : "O-O");
+    } else if (movedPiece->getType() == PieceType::PAWN) {
+        if (move.isCapture()) {
+            ss << (char) ('a' + move.getFrom().getCol() - 1) << 'x';
+        }
+        ss << move.getTo().toString();
+        if (move.getPromoteTo() != PieceType::NONE) {
+            ss << '=' << letterFromPieceType(move.getPromoteTo());
+        }
+    } else {
+        ss << letterFromPieceType(movedPiece->getType());
+
+        bool ambiguous = false;
+        bool sameCol = false;
+        bool sameRow = false;
+        for (auto piece: std::vector<Piece *>(game.getCurrentPlayer()->getPieces())) {
+            if (piece == movedPiece || piece->getType() != movedPiece->getType()) {
+                continue;
+            }
+            auto legalMoves = game.getLegalMovesFrom(piece->getPosition());
+            if (std::any_of(legalMoves.begin(), legalMoves.end(), [&move](const Move &other) {
+                return other.getTo() == move.getTo();
+            })) {
+                ambiguous = true;
+                sameCol = sameCol || piece->getPosition().getCol() == move.getFrom().getCol();
+                sameRow = sameRow || piece->getPosition().getRow() == move.getFrom().getRow();
+            }
+        }
+
+        if (ambiguous) {
+            if (!sameCol) {
+                ss << (char) ('a' + move.getFrom().getCol() - 1);
+            } else if (!sameRow) {
+                ss << move.getFrom().getRow();
+            } else {
+                ss << move.getFrom().toString();
+            }
+        }
+
+        if (move.isCapture()) {
+            ss << 'x';
+        }
+        ss << move.getTo().toString();
+    }
+
+    auto gameAfterMove = game.afterMove(move);
+    if (gameAfterMove.isCheck(gameAfterMove.getCurrentPlayer()->getColor())) {
+        ss << (gameAfterMove.isMate() ? '#' : '+');
+    }
+    return ss.str();
+}
+
+std::string PGNParser::movetextToString(const PgnGame &pgnGame) {
+    // the first move number and side to move are taken from the starting position, if there is one
+    bool whiteToMove = true;
+    int moveNumber = 1;
+    if (pgnGame.hasTag("FEN")) {
+        auto fields = split(pgnGame.getTag("FEN"), ' ');
+        if (fields.size() == 6) {
+            whiteToMove = (fields[1] != "b");
+            try {
+                moveNumber = std::stoi(fields[5]);
+            } catch (std::exception &e) {
+                moveNumber = 1;
+            }
+        }
+    }
+
+    std::vector<std::string> tokens;
+    for (size_t ply = 0; ply < pgnGame.moves.size(); ply++) {
+        if (whiteToMove) {
+            tokens.push_back(std::to_string(moveNumber) + ".");
+        } else if (ply == 0) {
+            tokens.push_back(std::to_string(moveNumber) + "...");
+        }
+        tokens.push_back(pgnGame.moves[ply]);
+
+        if (!whiteToMove) {
+            moveNumber++;
+        }
+        whiteToMove = !whiteToMove;
+    }
+
+    if (!pgnGame.result.empty()) {
+        tokens.push_back(pgnGame.result);
+    } else {
+        tokens.push_back(pgnGame.hasTag("Result") ? pgnGame.getTag("Result") : "*");
+    }
+
+    // lines of the movetext should not exceed 80 characters
+    std::stringstream ss;
+    size_t lineLength = 0;
+    for (const auto &token: tokens) {
+        if (lineLength > 0 && lineLength + 1 + token.size() > 79) {
+            ss << '\n';
+            lineLength = 0;
+        } else if (lineLength > 0) {
+            ss << ' ';
+            lineLength++;
+        }
+        ss << token;
+        lineLength += token.size();
+    }
+    ss << '\n';
+    return ss.str();
+}
+
+std::string PGNParser::gameToString(const PgnGame &pgnGame) {
+    std::stringstream ss;
+    for (const auto &tag: pgnGame.tags) {
+        ss << '[' << tag.first << " \"";
+        for (auto character: tag.second) {
+            if (character == '"' || character == '\\') {
+                ss << '\\';
+            }
+            ss << character;
+        }
+        ss << "\"]\n";
+    }
+    if (!pgnGame.tags.empty()) {
+        ss << '\n';
+    }
+    ss << PGNParser::movetextToString(pgnGame);
+    return ss.str();
+}
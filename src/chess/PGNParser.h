@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_PGNPARSER_H
+#define CHESS_PGNPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+class Game;
+class Move;
+
+/**
+ * Single game read from a PGN file - tag pairs, moves in standard algebraic notation and the game
+ * termination marker found at the end of the movetext
+ */
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::vector<std::string> moves;
+    std::string result;
+
+    /**
+     * @return value of the tag with a given name or an empty string if the game has no such tag
+     */
+    std::string getTag(const std::string &name) const;
+
+    bool hasTag(const std::string &name) const;
+};
+
+/**
+ * Handle parsing from and exporting to Portable Game Notation
+ * https://en.wikipedia.org/wiki/Portable_Game_Notation
+ */
+class PGNParser {
+private:
+    /**
+     * Parse a tag pair starting at the given offset, eg. [White "Kasparov, Garry"], and move the offset past it
+     */
+    static std::pair<std::string, std::string> parseTag(std::string_view pgn, size_t &offset);
+
+    static std::string movetextToString(const PgnGame &pgnGame);
+
+public:
+    /**
+     * Split the contents of a PGN file into the text of consecutive games, without copying.
+     * A new game starts at a tag pair line which follows the movetext of the previous game.
+     */
+    static std::vector<std::string_view> splitGames(std::string_view pgn);
+
+    /**
+     * Parse the text of a single game - tags, moves and the termination marker. Comments, variations,
+     * move numbers and numeric annotation glyphs are skipped.
+     * @throws PgnException if the text is malformed
+     */
+    static PgnGame parseGame(std::string_view pgn);
+
+    static std::vector<PgnGame> parseGames(std::string_view pgn);
+
+    /**
+     * Game in the starting position described by the SetUp/FEN tags or the standard one if there are none
+     * @throws FenException if the FEN tag is invalid
+     */
+    static Game initialGame(const PgnGame &pgnGame);
+
+    /**
+     * Find the legal move of the current player described by a move in standard algebraic notation
+     * eg. "Nbd7", "exd6", "O-O-O", "e8=Q+"
+     * @throws IllegalMoveException if there is no such legal move or the notation is ambiguous
+     */
+    static Move parseSan(const std::string &san, const Game &game);
+
+    /**
+     * Standard algebraic notation of a legal move in the current position of the game, including
+     * disambiguation and the check or mate suffix
+     */
+    static std::string moveToSan(const Move &move, const Game &game);
+
+    static std::string gameToString(const PgnGame &pgnGame);
+};
+
+
+#endif //CHESS_PGNPARSER_H
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PackedPosition.h"
+#include "Bitboard.h"
+#include "Game.h"
+#include "Board.h"
+#include "ChessExceptions.h"
+
+namespace {
+    constexpr size_t PIECES_OFFSET = 8;
+    constexpr size_t FLAGS_OFFSET = 24;
+    constexpr size_t EN_PASSANT_OFFSET = 25;
+    constexpr size_t HALFMOVE_CLOCK_OFFSET = 26;
+    constexpr size_t FULLMOVE_NUMBER_OFFSET = 28;
+    constexpr uint8_t NO_EN_PASSANT = 0xFF;
+
+    uint64_t readInteger(const uint8_t *bytes, size_t size) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; i++) {
+            value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    void writeInteger(uint8_t *bytes, uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    /**
+     * Bit n set if n is the code of a piece
+     */
+    constexpr uint16_t generateValidPieceCodes() {
+        uint16_t codes = 0;
+        for (auto color: {Color::WHITE, Color::BLACK}) {
+            for (auto type: {PieceType::PAWN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT, PieceType::KING,
+                             PieceType::QUEEN}) {
+                codes |= 1 << makePieceCode(color, type);
+            }
+        }
+        return codes;
+    }
+
+    constexpr uint16_t VALID_PIECE_CODES = generateValidPieceCodes();
+}
+
+PackedPosition PackedPosition::pack(const CompactPosition &position) {
+    PackedPosition packed{};
+    auto &bytes = packed.bytes;
+    Bitboard occupancy = 0;
+    size_t pieces = 0;
+    for (int index = 0; index < 64; index++) {
+        auto code = position.squares[index];
+        if (code == NO_PIECE) {
+            continue;
+        }
+        if (pieces == MAX_PIECES) {
+            throw ArchiveException("Cannot pack a position with more than 32 pieces");
+        }
+        occupancy |= squareBit(Square(index));
+        bytes[PIECES_OFFSET + pieces / 2] |= static_cast<uint8_t>(code << (4 * (pieces % 2)));
+        pieces++;
+    }
+    writeInteger(bytes.data(), occupancy, 8);
+
+    const auto &state = position.state;
+    bytes[FLAGS_OFFSET] = static_cast<uint8_t>(static_cast<uint8_t>(state.sideToMove) | state.castlingRights << 1);
+    bytes[EN_PASSANT_OFFSET] = (state.enPassantSquare == GameState::NO_EN_PASSANT)
+                               ? NO_EN_PASSANT
+                               : static_cast<uint8_t>(state.enPassantSquare);
+    writeInteger(bytes.data() + HALFMOVE_CLOCK_OFFSET, state.halfmoveClock, 2);
+    writeInteger(bytes.data() + FULLMOVE_NUMBER_OFFSET, state.fullmoveNumber, 2);
+    return packed;
+}
+
+PackedPosition PackedPosition::fromGame(const Game &game) {
+    return pack({game.getBoard()->getSquares(), game.getGameState()});
+}
+
+CompactPosition PackedPosition::unpack() const {
+    CompactPosition position{};
+    Bitboard occupancy = readInteger(bytes.data(), 8);
+    if (__builtin_popcountll(occupancy) > static_cast<int>(MAX_PIECES)) {
+        throw ArchiveException("Packed position has more than 32 pieces");
+    }
+
+    // the codes are checked once after the loop, which stays free of branches other than its condition
+    size_t pieces = 0;
+    uint16_t codes = 0;
+    while (occupancy != 0) {
+        auto square = popLowestSquare(occupancy);
+        auto code = static_cast<uint8_t>((bytes[PIECES_OFFSET + pieces / 2] >> (4 * (pieces % 2))) & 0xF);
+        codes |= 1 << code;
+        position.squares[square.getIndex()] = code;
+        pieces++;
+    }
+    if (codes & ~VALID_PIECE_CODES) {
+        throw ArchiveException("Invalid piece code in a packed position");
+    }
+
+    auto flags = bytes[FLAGS_OFFSET];
+    auto enPassant = bytes[EN_PASSANT_OFFSET];
+    if ((flags >> 5) != 0 || (enPassant != NO_EN_PASSANT && enPassant >= 64) || bytes[30] != 0 || bytes[31] != 0) {
+        throw ArchiveException("Invalid state of a packed position");
+    }
+    position.state.sideToMove = static_cast<Color>(flags & 1);
+    position.state.castlingRights = (flags >> 1) & GameState::ALL_CASTLING_RIGHTS;
+    position.state.enPassantSquare = (enPassant == NO_EN_PASSANT) ? GameState::NO_EN_PASSANT
+                                                                  : static_cast<int8_t>(enPassant);
+    position.state.halfmoveClock = readInteger(bytes.data() + HALFMOVE_CLOCK_OFFSET, 2);
+    position.state.fullmoveNumber = readInteger(bytes.data() + FULLMOVE_NUMBER_OFFSET, 2);
+    if (auto message = position.validate()) {
+        throw ArchiveException(std::string("Invalid packed position: ") + message);
+    }
+    return position;
+}
+
+Game PackedPosition::toGame() const {
+    return Game(unpack());
+}
+
+
+PackedPositionWriter::PackedPositionWriter(const std::string &path) :
+        file(path, std::ios::binary | std::ios::trunc), count(0), closed(false) {
+    if (!file) {
+        throw ArchiveException("Cannot open " + path + " for writing");
+    }
+    // the header is rewritten with the position count on close
+    uint8_t header[PackedPositionFile::headerSize] = {};
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+PackedPositionWriter::~PackedPositionWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void PackedPositionWriter::add(const PackedPosition &position) {
+    if (closed) {
+        throw ArchiveException("Cannot add a position to a closed file");
+    }
+    file.write(reinterpret_cast<const char *>(position.bytes.data()), PackedPosition::SIZE);
+    count++;
+}
+
+void PackedPositionWriter::add(const CompactPosition &position) {
+    add(PackedPosition::pack(position));
+}
+
+uint64_t PackedPositionWriter::getCount() const {
+    return count;
+}
+
+void PackedPositionWriter::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+
+    uint8_t header[PackedPositionFile::headerSize];
+    memcpy(header, PackedPositionFile::magic, sizeof(PackedPositionFile::magic));
+    writeInteger(header + 4, PackedPositionFile::version, 2);
+    writeInteger(header + 6, PackedPosition::SIZE, 2);
+    writeInteger(header + 8, count, 8);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.close();
+    if (!file) {
+        throw ArchiveException("Cannot write the packed positions");
+    }
+}
+
+
+PackedPositionReader::PackedPositionReader(const std::string &path) : data(nullptr), size(0), count(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ArchiveException("Cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t) PackedPositionFile::headerSize) {
+        ::close(fd);
+        throw ArchiveException(path + " is not a file of packed positions");
+    }
+
+    size = fileStat.st_size;
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw ArchiveException("Cannot map " + path + ": " + strerror(errno));
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t *>(mapping);
+
+    count = readInteger(data + 8, 8);
+    if (memcmp(data, PackedPositionFile::magic, sizeof(PackedPositionFile::magic)) != 0 ||
+        readInteger(data + 4, 2) != PackedPositionFile::version ||
+        readInteger(data + 6, 2) != PackedPosition::SIZE ||
+        (size - PackedPositionFile::headerSize) / PackedPosition::SIZE != count ||
+        (size - PackedPositionFile::headerSize) % PackedPosition::SIZE != 0) {
+        munmap(const_cast<uint8_t *>(data), size);
+        throw ArchiveException(path + " is not a valid file of packed positions");
+    }
+}
+
+PackedPositionReader::~PackedPositionReader() {
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+size_t PackedPositionReader::getCount() const {
+    return count;
+}
+
+PackedPosition PackedPositionReader::getPosition(size_t index) const {
+    if (index >= count) {
+        throw ArchiveException("Position index out of range");
+    }
+    PackedPosition position;
+    memcpy(position.bytes.data(), data + PackedPositionFile::headerSize + index * PackedPosition::SIZE,
+           PackedPosition::SIZE);
+    return position;
+}
+
+void PackedPositionReader::unpack(size_t first, size_t positionCount, CompactPosition *output) const {
+    if (first > count || count - first < positionCount) {
+        throw ArchiveException("Position range out of bounds");
+    }
+    for (size_t i = 0; i < positionCount; i++) {
+        output[i] = getPosition(first + i).unpack();
+    }
+}
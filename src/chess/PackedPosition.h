@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_PACKEDPOSITION_H
+#define CHESS_PACKEDPOSITION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "CompactPosition.h"
+
+class Game;
+
+/**
+ * Position encoded in 32 bytes, for datasets of millions of positions. All integers are little-endian.
+ *
+ *  bytes 0-7    occupancy - bit n set if there is a piece on the field with Square index n
+ *  bytes 8-23   piece codes of the occupied fields from the lowest index, 4 bits each, the lower half of a byte first
+ *  byte 24      side to move in bit 0, castling rights in bits 1-4
+ *  byte 25      en passant target field index, 0xFF if there is none
+ *  bytes 26-27  halfmove clock
+ *  bytes 28-29  fullmove number
+ *  bytes 30-31  zero
+ */
+struct PackedPosition {
+    static constexpr size_t SIZE = 32;
+    static constexpr size_t MAX_PIECES = 32;
+
+    std::array<uint8_t, SIZE> bytes;
+
+    /**
+     * @throws ArchiveException if there are more than 32 pieces on the board
+     */
+    static PackedPosition pack(const CompactPosition &position);
+
+    static PackedPosition fromGame(const Game &game);
+
+    /**
+     * @throws ArchiveException if the bytes are not a valid packed position or the position breaks
+     * the rules checked for a FEN string, see CompactPosition::validate
+     */
+    CompactPosition unpack() const;
+
+    Game toGame() const;
+
+    bool operator==(const PackedPosition &other) const {
+        return bytes == other.bytes;
+    }
+};
+
+static_assert(sizeof(PackedPosition) == PackedPosition::SIZE, "PackedPosition must have no padding");
+
+/**
+ * File of packed positions - a header (magic "CHPP", u16 version, u16 record size, u64 position count)
+ * followed by the positions
+ */
+class PackedPositionFile {
+public:
+    static constexpr char magic[4] = {'C', 'H', 'P', 'P'};
+    static constexpr uint16_t version = 1;
+    static constexpr size_t headerSize = 16;
+};
+
+/**
+ * Appends positions to a new file, the count in the header is written on close
+ */
+class PackedPositionWriter {
+private:
+    std::ofstream file;
+    uint64_t count;
+    bool closed;
+
+public:
+    /**
+     * @throws ArchiveException if the file cannot be created
+     */
+    explicit PackedPositionWriter(const std::string &path);
+
+    ~PackedPositionWriter();
+
+    void add(const PackedPosition &position);
+
+    void add(const CompactPosition &position);
+
+    uint64_t getCount() const;
+
+    void close();
+};
+
+/**
+ * Read-only view of a file of packed positions mapped into memory
+ */
+class PackedPositionReader {
+private:
+    const uint8_t *data;
+    size_t size;
+    size_t count;
+
+public:
+    /**
+     * @throws ArchiveException if the file cannot be mapped or is not a valid file of packed positions
+     */
+    explicit PackedPositionReader(const std::string &path);
+
+    ~PackedPositionReader();
+
+    PackedPositionReader(const PackedPositionReader &) = delete;
+
+    PackedPositionReader &operator=(const PackedPositionReader &) = delete;
+
+    size_t getCount() const;
+
+    PackedPosition getPosition(size_t index) const;
+
+    /**
+     * Unpack the positions [first, first + positionCount) into the output array
+     * @throws ArchiveException if the range is out of bounds or a position is invalid
+     */
+    void unpack(size_t first, size_t positionCount, CompactPosition *output) const;
+};
+
+
+#endif //CHESS_PACKEDPOSITION_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <memory>
+#include <sstream>
+#include "PgnValidator.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "Color.h"
+#include "PGNParser.h"
+#include "ChessExceptions.h"
+
+std::string PgnValidator::errorName(ValidationError error) {
+    switch (error) {
+        case ValidationError::PARSE_ERROR:
+            return "parse error";
+        case ValidationError::BAD_FEN:
+            return "bad FEN tag";
+        case ValidationError::ILLEGAL_MOVE:
+            return "illegal move";
+        case ValidationError::WRONG_RESULT:
+            return "wrong result";
+        default:
+            return "ok";
+    }
+}
+
+std::string PgnValidator::gameOverName(GameOver gameOver) {
+    switch (gameOver) {
+        case GameOver::MATE:
+            return "checkmate";
+        case GameOver::STALEMATE:
+            return "stalemate";
+        case GameOver::INSUFFICIENT_MATERIAL:
+            return "insufficient material";
+        case GameOver::FIFTY_MOVE_RULE:
+            return "fifty move rule";
+        case GameOver::THREEFOLD_REPETITION:
+            return "threefold repetition";
+        default:
+            return "not over";
+    }
+}
+
+bool PgnValidator::isValidResult(const std::string &result) {
+    return result == "1-0" || result == "0-1" || result == "1/2-1/2" || result == "*";
+}
+
+GameReport PgnValidator::validateGame(std::string_view gameText) {
+    GameReport report;
+    PgnGame pgnGame;
+    try {
+        pgnGame = PGNParser::parseGame(gameText);
+    } catch (const PgnException &e) {
+        report.error = ValidationError::PARSE_ERROR;
+        report.detail = e.what();
+        return report;
+    }
+    if (pgnGame.hasTag("White") || pgnGame.hasTag("Black")) {
+        report.players = pgnGame.getTag("White") + " - " + pgnGame.getTag("Black");
+    }
+
+    auto tagResult = pgnGame.getTag("Result");
+    auto recordedResult = pgnGame.result.empty() ? tagResult : pgnGame.result;
+    if (!tagResult.empty() && !isValidResult(tagResult)) {
+        report.error = ValidationError::WRONG_RESULT;
+        report.detail = "invalid Result tag \"" + tagResult + "\"";
+        return report;
+    }
+    if (!tagResult.empty() && !pgnGame.result.empty() && tagResult != pgnGame.result) {
+        report.error = ValidationError::WRONG_RESULT;
+        report.detail = "Result tag " + tagResult + " differs from movetext result " + pgnGame.result;
+        return report;
+    }
+    if (recordedResult.empty()) {
+        report.error = ValidationError::WRONG_RESULT;
+        report.detail = "missing game result";
+        return report;
+    }
+
+    std::unique_ptr<Game> game;
+    try {
+        game = std::make_unique<Game>(PGNParser::initialGame(pgnGame));
+    } catch (const FenException &e) {
+        report.error = ValidationError::BAD_FEN;
+        report.detail = e.what();
+        return report;
+    }
+
+    for (size_t ply = 0; ply < pgnGame.moves.size(); ply++) {
+        const auto &san = pgnGame.moves[ply];
+        try {
+            game->makeMove(PGNParser::parseSan(san, *game));
+        } catch (const std::exception &e) {
+            std::stringstream ss;
+            ss << "ply " << ply + 1 << " (" << san << "): " << e.what();
+            report.error = ValidationError::ILLEGAL_MOVE;
+            report.detail = ss.str();
+            return report;
+        }
+    }
+
+    // a draw by repetition or the fifty move rule has to be claimed, the game may still be won afterwards
+    auto gameOver = game->isOver();
+    std::string expectedResult;
+    if (gameOver == GameOver::MATE) {
+        expectedResult = (game->getCurrentPlayer()->getColor() == Color::WHITE) ? "0-1" : "1-0";
+    } else if (gameOver == GameOver::STALEMATE || gameOver == GameOver::INSUFFICIENT_MATERIAL) {
+        expectedResult = "1/2-1/2";
+    }
+
+    if (!expectedResult.empty() && recordedResult != expectedResult) {
+        report.error = ValidationError::WRONG_RESULT;
+        report.detail = "recorded " + recordedResult + " but the game ends by " + gameOverName(gameOver) +
+                        ", expected " + expectedResult;
+    }
+    return report;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_PGNVALIDATOR_H
+#define CHESS_PGNVALIDATOR_H
+
+#include <string>
+#include <string_view>
+#include "GameOver.h"
+
+enum class ValidationError {
+    NONE,
+    PARSE_ERROR,
+    BAD_FEN,
+    ILLEGAL_MOVE,
+    WRONG_RESULT,
+};
+
+/**
+ * Outcome of validating a single game - the first error found, the players from the tags and
+ * a human readable description of the error
+ */
+struct GameReport {
+    ValidationError error = ValidationError::NONE;
+    std::string players;
+    std::string detail;
+};
+
+/**
+ * Check games read from PGN files against the library rules
+ */
+class PgnValidator {
+private:
+    static std::string gameOverName(GameOver gameOver);
+
+    static bool isValidResult(const std::string &result);
+
+public:
+    static std::string errorName(ValidationError error);
+
+    /**
+     * Replay the game with the library rules and check that every move is legal and the recorded result
+     * agrees with the final position. Only the endings which finish the game by themselves - checkmate,
+     * stalemate and insufficient material - decide the result, a game may go on or be resigned after
+     * a threefold repetition or fifty moves unless a player claims the draw.
+     */
+    static GameReport validateGame(std::string_view gameText);
+};
+
+#endif //CHESS_PGNVALIDATOR_H
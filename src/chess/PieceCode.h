@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_PIECECODE_H
+#define CHESS_PIECECODE_H
+
+#include <array>
+#include <cstdint>
+#include "Color.h"
+#include "pieces/PieceType.h"
+
+/**
+ * Compact representation of a piece used by the move generator - the piece type in the lower three bits
+ * and the color in the fourth, 0 for an empty field
+ */
+using PieceCode = uint8_t;
+
+/**
+ * Piece codes of all fields, indexed like Position::getIndex
+ */
+using BoardSquares = std::array<PieceCode, 64>;
+
+constexpr PieceCode NO_PIECE = 0;
+
+constexpr PieceCode makePieceCode(Color color, PieceType type) {
+    return static_cast<PieceCode>(static_cast<uint8_t>(type) | static_cast<uint8_t>(color) << 3);
+}
+
+constexpr PieceType pieceTypeOf(PieceCode code) {
+    return static_cast<PieceType>(code & 0x7);
+}
+
+constexpr Color pieceColorOf(PieceCode code) {
+    return static_cast<Color>(code >> 3);
+}
+
+
+#endif //CHESS_PIECECODE_H
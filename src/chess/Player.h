@@ -8,11 +8,12 @@
 #ifndef CHESS_PLAYER_H
 #define CHESS_PLAYER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 class Piece;
-enum class Color;
+enum class Color : uint8_t;
 
 
 /**
@@ -73,7 +73,13 @@ bool Position::offsetWithinBounds(int rowOffset, int colOffset) const {
     return Position::withinBounds(this->getRow() + rowOffset, this->getCol() + colOffset);
 }
 
-Position *Position::copy(Position position) {
-    return new Position(position.getRow(), position.getCol());
+int Position::getIndex() const {
+    return (row - 1) * BOARD_SIZE + column - 1;
 }
 
+Position Position::fromIndex(int index) {
+    if (index < 0 || index >= BOARD_SIZE * BOARD_SIZE) {
+        throw std::invalid_argument("Invalid field index");
+    }
+    return {index / BOARD_SIZE + 1, index % BOARD_SIZE + 1};
+}
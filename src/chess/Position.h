@@ -10,7 +10,11 @@
 
 
 #include <string>
+#include "Square.h"
 
+/**
+ * Field of the board given by the user, checked on construction. The engine works on Square internally.
+ */
 class Position {
 private:
     int column;
@@ -19,6 +23,11 @@ private:
 public:
     Position(int row, int col);
 
+    /**
+     * Position of a valid square, not checked
+     */
+    explicit Position(Square square) : column(square.getFile() + 1), row(square.getRank() + 1) {}
+
     int getRow() const;
 
     int getCol() const;
@@ -45,9 +54,21 @@ public:
      */
     static Position fromString(std::string positionString);
 
-    static Position *copy(Position position);
-
     static bool withinBounds(int row, int col);
+
+    /**
+     * Index of the field on the board, (row - 1) * 8 + (col - 1), a1 = 0, h8 = 63
+     */
+    int getIndex() const;
+
+    Square toSquare() const {
+        return Square::at(row - 1, column - 1);
+    }
+
+    /**
+     * @throw std::invalid_argument if index is outside 0-63
+     */
+    static Position fromIndex(int index);
 };
 
 
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <queue>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PositionIndex.h"
+#include "GameArchive.h"
+#include "FENParser.h"
+#include "Game.h"
+#include "ChessExceptions.h"
+
+namespace {
+    void appendInteger(std::string &output, uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            output += static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    void appendVarint(std::string &output, uint64_t value) {
+        while (value >= 0x80) {
+            output += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        output += static_cast<char>(value);
+    }
+
+    uint64_t readInteger(const uint8_t *data, size_t size) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; i++) {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t readVarint(const uint8_t *&data, const uint8_t *end) {
+        uint64_t value = 0;
+        for (int shift = 0; data < end && shift < 64; shift += 7) {
+            auto byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw ArchiveException("Corrupted posting list in position index");
+    }
+}
+
+bool PositionMatch::operator==(const PositionMatch &rhs) const {
+    return gameIndex == rhs.gameIndex && ply == rhs.ply;
+}
+
+bool PositionIndexBuilder::Entry::operator<(const Entry &rhs) const {
+    if (hash != rhs.hash) {
+        return hash < rhs.hash;
+    }
+    if (gameIndex != rhs.gameIndex) {
+        return gameIndex < rhs.gameIndex;
+    }
+    return ply < rhs.ply;
+}
+
+PositionIndexBuilder::PositionIndexBuilder(std::string path, size_t runCapacity)
+        : path(std::move(path)), runCapacity(std::max<size_t>(1, runCapacity)), finished(false) {
+    buffer.reserve(std::min<size_t>(this->runCapacity, 1 << 20));
+}
+
+PositionIndexBuilder::~PositionIndexBuilder() {
+    removeRuns();
+}
+
+void PositionIndexBuilder::addPosition(uint64_t hash, uint32_t gameIndex, uint32_t ply) {
+    if (finished) {
+        throw ArchiveException("Cannot add positions to a finished index");
+    }
+    buffer.push_back({hash, gameIndex, ply});
+    if (buffer.size() >= runCapacity) {
+        flushRun();
+    }
+}
+
+void PositionIndexBuilder::addGame(const ArchivedGame &archivedGame, uint32_t gameIndex) {
+    GameArchive::replay(archivedGame, [this, gameIndex](const Game &game, size_t ply) {
+        addPosition(game.getHash(), gameIndex, ply);
+    });
+}
+
+void PositionIndexBuilder::flushRun() {
+    std::sort(buffer.begin(), buffer.end());
+    auto runPath = path + ".run" + std::to_string(runPaths.size());
+    std::ofstream run(runPath, std::ios::binary | std::ios::trunc);
+    run.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Entry)));
+    if (!run) {
+        throw ArchiveException("Cannot write temporary file " + runPath);
+    }
+    runPaths.push_back(runPath);
+    buffer.clear();
+}
+
+void PositionIndexBuilder::removeRuns() {
+    for (const auto &runPath: runPaths) {
+        std::remove(runPath.c_str());
+    }
+    runPaths.clear();
+}
+
+void PositionIndexBuilder::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+
+    if (runPaths.empty()) {
+        std::sort(buffer.begin(), buffer.end());
+        size_t next = 0;
+        writeIndex([this, &next](Entry &entry) {
+            if (next == buffer.size()) {
+                return false;
+            }
+            entry = buffer[next++];
+            return true;
+        });
+        buffer = {};
+        return;
+    }
+
+    if (!buffer.empty()) {
+        flushRun();
+    }
+    buffer = {};
+
+    // k-way merge of the sorted runs
+    std::vector<std::unique_ptr<std::ifstream>> runs;
+    using HeapItem = std::pair<Entry, size_t>;
+    auto heapOrder = [](const HeapItem &lhs, const HeapItem &rhs) { return rhs.first < lhs.first; };
+    std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(heapOrder)> heap(heapOrder);
+
+    for (const auto &runPath: runPaths) {
+        runs.push_back(std::make_unique<std::ifstream>(runPath, std::ios::binary));
+        Entry entry{};
+        if (runs.back()->read(reinterpret_cast<char *>(&entry), sizeof(Entry))) {
+            heap.emplace(entry, runs.size() - 1);
+        }
+    }
+
+    writeIndex([&heap, &runs](Entry &entry) {
+        if (heap.empty()) {
+            return false;
+        }
+        auto top = heap.top();
+        heap.pop();
+        entry = top.first;
+
+        Entry next{};
+        if (runs[top.second]->read(reinterpret_cast<char *>(&next), sizeof(Entry))) {
+            heap.emplace(next, top.second);
+        }
+        return true;
+    });
+
+    runs.clear();
+    removeRuns();
+}
+
+void PositionIndexBuilder::writeIndex(const std::function<bool(Entry &)> &nextEntry) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    auto keysPath = path + ".keys";
+    std::ofstream keysFile(keysPath, std::ios::binary | std::ios::trunc);
+    if (!file || !keysFile) {
+        throw ArchiveException("Cannot open " + path + " for writing");
+    }
+
+    std::string header(PositionIndex::headerSize, '\0');
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    uint64_t offset = PositionIndex::headerSize;
+    uint64_t positionCount = 0;
+    uint64_t postingCount = 0;
+    std::vector<Entry> postings;
+    std::string encoded;
+    std::string keyEntry;
+
+    auto writePostings = [&]() {
+        encoded.clear();
+        appendVarint(encoded, postings.size());
+        uint32_t previousGame = 0;
+        for (const auto &posting: postings) {
+            appendVarint(encoded, posting.gameIndex - previousGame);
+            appendVarint(encoded, posting.ply);
+            previousGame = posting.gameIndex;
+        }
+        file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+
+        keyEntry.clear();
+        appendInteger(keyEntry, postings[0].hash, 8);
+        appendInteger(keyEntry, offset, 8);
+        keysFile.write(keyEntry.data(), static_cast<std::streamsize>(keyEntry.size()));
+
+        offset += encoded.size();
+        positionCount++;
+        postingCount += postings.size();
+        postings.clear();
+    };
+
+    Entry entry{};
+    while (nextEntry(entry)) {
+        if (!postings.empty() && postings.back().hash != entry.hash) {
+            writePostings();
+        }
+        postings.push_back(entry);
+    }
+    if (!postings.empty()) {
+        writePostings();
+    }
+
+    keysFile.close();
+    std::ifstream keysInput(keysPath, std::ios::binary);
+    if (positionCount > 0) {
+        file << keysInput.rdbuf();
+    }
+    keysInput.close();
+    std::remove(keysPath.c_str());
+
+    header.clear();
+    header.append(PositionIndex::magic, sizeof(PositionIndex::magic));
+    appendInteger(header, PositionIndex::version, 2);
+    appendInteger(header, 0, 2);
+    appendInteger(header, positionCount, 8);
+    appendInteger(header, offset, 8);
+    appendInteger(header, postingCount, 8);
+    file.seekp(0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.close();
+    if (!file) {
+        throw ArchiveException("Cannot write " + path);
+    }
+}
+
+
+PositionIndexReader::PositionIndexReader(const std::string &path)
+        : data(nullptr), size(0), positionCount(0), postingCount(0), keys(nullptr) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ArchiveException("Cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t) PositionIndex::headerSize) {
+        ::close(fd);
+        throw ArchiveException(path + " is not a position index");
+    }
+
+    size = fileStat.st_size;
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw ArchiveException("Cannot map " + path + ": " + strerror(errno));
+    }
+    data = static_cast<const uint8_t *>(mapping);
+
+    positionCount = readInteger(data + 8, 8);
+    auto keysOffset = readInteger(data + 16, 8);
+    postingCount = readInteger(data + 24, 8);
+    if (memcmp(data, PositionIndex::magic, sizeof(PositionIndex::magic)) != 0 ||
+        readInteger(data + 4, 2) != PositionIndex::version ||
+        keysOffset > size || (size - keysOffset) / PositionIndex::keyEntrySize < positionCount) {
+        munmap(const_cast<uint8_t *>(data), size);
+        throw ArchiveException(path + " is not a valid position index");
+    }
+    keys = data + keysOffset;
+}
+
+PositionIndexReader::~PositionIndexReader() {
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+size_t PositionIndexReader::getPositionCount() const {
+    return positionCount;
+}
+
+size_t PositionIndexReader::getPostingCount() const {
+    return postingCount;
+}
+
+std::vector<PositionMatch> PositionIndexReader::find(uint64_t hash) const {
+    // binary search for the first key not lower than the hash
+    uint64_t low = 0;
+    uint64_t high = positionCount;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (readInteger(keys + middle * PositionIndex::keyEntrySize, 8) < hash) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == positionCount || readInteger(keys + low * PositionIndex::keyEntrySize, 8) != hash) {
+        return {};
+    }
+
+    auto postingsOffset = readInteger(keys + low * PositionIndex::keyEntrySize + 8, 8);
+    if (postingsOffset >= size) {
+        throw ArchiveException("Corrupted position index");
+    }
+    const uint8_t *postings = data + postingsOffset;
+    const uint8_t *end = data + size;
+
+    auto count = readVarint(postings, end);
+    std::vector<PositionMatch> matches;
+    matches.reserve(std::min<uint64_t>(count, postingCount));
+    uint64_t gameIndex = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        gameIndex += readVarint(postings, end);
+        auto ply = readVarint(postings, end);
+        matches.push_back({static_cast<uint32_t>(gameIndex), static_cast<uint32_t>(ply)});
+    }
+    return matches;
+}
+
+std::vector<PositionMatch> PositionIndexReader::find(const Game &game) const {
+    return find(game.getHash());
+}
+
+std::vector<PositionMatch> PositionIndexReader::findFen(const std::string &fen) const {
+    std::unique_ptr<Game> game(new Game(FENParser::parseGame(fen)));
+    return find(*game);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_POSITIONINDEX_H
+#define CHESS_POSITIONINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+class Game;
+struct ArchivedGame;
+
+/**
+ * Occurrence of a position in a game archive - index of the game in the archive and the number of plies played
+ * before the position was reached
+ */
+struct PositionMatch {
+    uint32_t gameIndex;
+    uint32_t ply;
+
+    bool operator==(const PositionMatch &rhs) const;
+};
+
+/**
+ * Index file mapping Zobrist hashes of positions to posting lists of games reaching them.
+ *
+ * File layout (all integers little-endian):
+ *  header   - magic "CHPI", u16 version, u16 reserved, u64 number of distinct positions, u64 offset of the key
+ *             table, u64 total number of postings
+ *  postings - for every position a varint count followed by (varint game index delta, varint ply) pairs,
+ *             sorted by game index and ply
+ *  keys     - (u64 hash, u64 offset of the posting list) for every position, sorted by hash
+ */
+class PositionIndex {
+public:
+    static constexpr char magic[4] = {'C', 'H', 'P', 'I'};
+    static constexpr uint16_t version = 1;
+    static constexpr size_t headerSize = 32;
+    static constexpr size_t keyEntrySize = 16;
+};
+
+/**
+ * Builds the index with an external sort - positions are buffered in memory, sorted runs are spilled to
+ * temporary files next to the output and merged when the index is finished
+ */
+class PositionIndexBuilder {
+private:
+    struct Entry {
+        uint64_t hash;
+        uint32_t gameIndex;
+        uint32_t ply;
+
+        bool operator<(const Entry &rhs) const;
+    };
+
+    std::string path;
+    size_t runCapacity;
+    std::vector<Entry> buffer;
+    std::vector<std::string> runPaths;
+    bool finished;
+
+    void flushRun();
+
+    /**
+     * Write the index file from entries supplied in sorted order by the given source,
+     * which returns false when there are no more entries
+     */
+    void writeIndex(const std::function<bool(Entry &)> &nextEntry);
+
+    void removeRuns();
+
+public:
+    /**
+     * @param runCapacity number of positions kept in memory before a sorted run is written to disk
+     */
+    explicit PositionIndexBuilder(std::string path, size_t runCapacity = 1 << 24);
+
+    ~PositionIndexBuilder();
+
+    PositionIndexBuilder(const PositionIndexBuilder &) = delete;
+
+    PositionIndexBuilder &operator=(const PositionIndexBuilder &) = delete;
+
+    void addPosition(uint64_t hash, uint32_t gameIndex, uint32_t ply);
+
+    /**
+     * Replay the game and add every position reached in it, including the starting one
+     */
+    void addGame(const ArchivedGame &archivedGame, uint32_t gameIndex);
+
+    void finish();
+};
+
+/**
+ * Read-only view of an index file mapped into memory, lookups are a binary search over the key table
+ */
+class PositionIndexReader {
+private:
+    const uint8_t *data;
+    size_t size;
+    uint64_t positionCount;
+    uint64_t postingCount;
+    const uint8_t *keys;
+
+public:
+    /**
+     * @throws ArchiveException if the file cannot be mapped or is not a valid index
+     */
+    explicit PositionIndexReader(const std::string &path);
+
+    ~PositionIndexReader();
+
+    PositionIndexReader(const PositionIndexReader &) = delete;
+
+    PositionIndexReader &operator=(const PositionIndexReader &) = delete;
+
+    size_t getPositionCount() const;
+
+    size_t getPostingCount() const;
+
+    std::vector<PositionMatch> find(uint64_t hash) const;
+
+    std::vector<PositionMatch> find(const Game &game) const;
+
+    /**
+     * @throws FenException if the FEN is invalid
+     */
+    std::vector<PositionMatch> findFen(const std::string &fen) const;
+};
+
+
+#endif //CHESS_POSITIONINDEX_H
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+#include "SessionManager.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "GameOver.h"
+#include "FENParser.h"
+#include "ChessExceptions.h"
+
+namespace {
+    std::string_view nextWord(std::string_view &text) {
+        auto start = text.find_first_not_of(' ');
+        if (start == std::string_view::npos) {
+            text = {};
+            return {};
+        }
+        auto end = std::min(text.find(' ', start), text.size());
+        auto word = text.substr(start, end - start);
+        text.remove_prefix(end);
+        return word;
+    }
+
+    std::string_view trim(std::string_view text) {
+        auto start = text.find_first_not_of(' ');
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(start, text.find_last_not_of(' ') - start + 1);
+    }
+
+    const char *resultName(GameOver result) {
+        switch (result) {
+            case GameOver::NOT_OVER:
+                return "playing";
+            case GameOver::MATE:
+                return "mate";
+            case GameOver::STALEMATE:
+                return "stalemate";
+            case GameOver::INSUFFICIENT_MATERIAL:
+                return "insufficient-material";
+            case GameOver::FIFTY_MOVE_RULE:
+                return "fifty-move-rule";
+            case GameOver::THREEFOLD_REPETITION:
+                return "threefold-repetition";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Lends the history of a session to a game for the time of a command and takes it back, also when
+     * the command fails
+     */
+    class HistoryLoan {
+    private:
+        Game &game;
+        HistoryManager &history;
+
+    public:
+        HistoryLoan(Game &game, HistoryManager &history) : game(game), history(history) {
+            game.swapHistory(history);
+        }
+
+        ~HistoryLoan() {
+            game.swapHistory(history);
+        }
+
+        HistoryLoan(const HistoryLoan &) = delete;
+
+        HistoryLoan &operator=(const HistoryLoan &) = delete;
+    };
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t microseconds) {
+    if (microseconds < LINEAR_BUCKETS) {
+        return microseconds;
+    }
+    // the highest bit selects the power of two, the next three the bucket within it
+    int exponent = 63 - __builtin_clzll(microseconds);
+    auto fraction = (microseconds >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return LINEAR_BUCKETS + (exponent - 6) * SUB_BUCKETS + fraction;
+}
+
+uint64_t LatencyHistogram::upperBoundOf(size_t bucket) {
+    if (bucket < LINEAR_BUCKETS) {
+        return bucket;
+    }
+    auto exponent = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 6;
+    auto fraction = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + fraction + 1) << (exponent - 3)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t microseconds) {
+    buckets[bucketOf(microseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    uint64_t count = 0;
+    for (const auto &bucket: buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return upperBoundOf(i);
+        }
+    }
+    return upperBoundOf(BUCKET_COUNT - 1);
+}
+
+
+SessionManager::SessionManager(size_t shardCount) : startTime(std::chrono::steady_clock::now()) {
+    for (size_t i = 0; i < std::max<size_t>(1, shardCount); i++) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+    for (auto &shard: shards) {
+        shard->worker = std::thread(runWorker, std::ref(*shard));
+    }
+}
+
+SessionManager::~SessionManager() {
+    for (auto &shard: shards) {
+        {
+            std::lock_guard<std::mutex> lock(shard->queueMutex);
+            shard->stopping = true;
+        }
+        shard->queueChanged.notify_one();
+    }
+    for (auto &shard: shards) {
+        shard->worker.join();
+    }
+}
+
+void SessionManager::runWorker(Shard &shard) {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(shard.queueMutex);
+            shard.queueChanged.wait(lock, [&shard]() { return shard.stopping || !shard.queue.empty(); });
+            if (shard.queue.empty()) {
+                return;
+            }
+            task = std::move(shard.queue.front());
+            shard.queue.pop_front();
+        }
+        task();
+    }
+}
+
+SessionManager::Shard &SessionManager::shardOf(uint64_t id) {
+    return *shards[id % shards.size()];
+}
+
+std::future<std::string> SessionManager::execute(std::string_view command) {
+    auto reply = std::make_shared<std::promise<std::string>>();
+    auto future = reply->get_future();
+    commands.fetch_add(1, std::memory_order_relaxed);
+
+    std::string_view rest = command;
+    std::string name(nextWord(rest));
+    uint64_t id;
+    if (name == "stats") {
+        reply->set_value(formatStats());
+        return future;
+    } else if (name == "create") {
+        id = nextId.fetch_add(1, std::memory_order_relaxed);
+    } else if (name != "move" && name != "moves" && name != "status" && name != "fen" && name != "close") {
+        reply->set_value(name.empty() ? "error Empty command" : "error Unknown command " + name);
+        return future;
+    } else {
+        auto idWord = nextWord(rest);
+        auto [end, error] = std::from_chars(idWord.data(), idWord.data() + idWord.size(), id);
+        if (idWord.empty() || error != std::errc() || end != idWord.data() + idWord.size()) {
+            reply->set_value("error Invalid session id");
+            return future;
+        }
+    }
+
+    auto &shard = shardOf(id);
+    auto task = [this, &shard, reply, name, id, argument = std::string(trim(rest)),
+                 queuedAt = std::chrono::steady_clock::now()]() {
+        std::string result;
+        try {
+            result = runCommand(shard, name, id, argument);
+        } catch (const std::exception &e) {
+            result = std::string("error ") + e.what();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - queuedAt;
+        latencies.record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        reply->set_value(std::move(result));
+    };
+    {
+        std::lock_guard<std::mutex> lock(shard.queueMutex);
+        shard.queue.emplace_back(std::move(task));
+    }
+    shard.queueChanged.notify_one();
+    return future;
+}
+
+std::string SessionManager::runCommand(Shard &shard, const std::string &name, uint64_t id,
+                                       const std::string &argument) {
+    if (name == "create") {
+        auto game = argument.empty() ? Game() : FENParser::parseGame(argument);
+        shard.sessions.emplace(id, Session{PackedPosition::fromGame(game), HistoryManager()});
+        games.fetch_add(1, std::memory_order_relaxed);
+        return "ok " + std::to_string(id);
+    }
+
+    auto found = shard.sessions.find(id);
+    if (found == shard.sessions.end()) {
+        throw SessionException("No session " + std::to_string(id));
+    }
+    auto &session = found->second;
+    if (name == "close") {
+        shard.sessions.erase(found);
+        games.fetch_sub(1, std::memory_order_relaxed);
+        return "ok";
+    }
+
+    Game game(session.position.unpack());
+    game.setMoveCache(&moveCache);
+    if (name == "moves") {
+        std::string reply = "ok";
+        for (const auto &move: game.getLegalMovesForPlayer(game.getCurrentPlayer())) {
+            for (const auto &choice: move.withPromotionChoices()) {
+                reply += ' ';
+                reply += choice.toSmithNotation();
+            }
+        }
+        return reply;
+    } else if (name == "fen") {
+        return "ok " + FENParser::gameToString(game);
+    }
+
+    // the result depends on repetitions of the earlier positions, so the game needs the recorded moves
+    HistoryLoan loan(game, session.history);
+    if (name == "move") {
+        if (game.isOver() != GameOver::NOT_OVER) {
+            throw SessionException("The game is over");
+        }
+        auto move = Move::parseSmithNotation(argument, game);
+        if (!game.isLegal(move)) {
+            throw IllegalMoveException("Illegal move " + argument);
+        }
+        game.makeMove(move);
+        session.position = PackedPosition::fromGame(game);
+        moves.fetch_add(1, std::memory_order_relaxed);
+        return "ok";
+    } else if (name == "status") {
+        auto side = (game.getGameState().sideToMove == Color::WHITE) ? " w" : " b";
+        return std::string("ok ") + resultName(game.isOver()) + side;
+    }
+    throw SessionException("Unknown command " + name);
+}
+
+std::string SessionManager::formatStats() const {
+    auto stats = getStats();
+    std::ostringstream reply;
+    reply << "ok games=" << stats.games << " moves=" << stats.moves << " commands=" << stats.commands
+          << " uptime=" << stats.uptimeSeconds << " moves/s=" << static_cast<uint64_t>(stats.movesPerSecond)
+          << " p99=" << stats.p99Microseconds << "us cache=" << static_cast<int>(stats.cacheHitRate) << "%";
+    return reply.str();
+}
+
+SessionStats SessionManager::getStats() const {
+    SessionStats stats{};
+    stats.games = games.load(std::memory_order_relaxed);
+    stats.moves = moves.load(std::memory_order_relaxed);
+    stats.commands = commands.load(std::memory_order_relaxed);
+    stats.uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    stats.movesPerSecond = (stats.uptimeSeconds > 0) ? static_cast<double>(stats.moves) / stats.uptimeSeconds : 0;
+    stats.p99Microseconds = latencies.percentile(0.99);
+    auto lookups = moveCache.getHits() + moveCache.getMisses();
+    stats.cacheHitRate = (lookups > 0) ? 100.0 * static_cast<double>(moveCache.getHits()) / lookups : 0;
+    return stats;
+}
+
+size_t SessionManager::getShardCount() const {
+    return shards.size();
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_SESSIONMANAGER_H
+#define CHESS_SESSIONMANAGER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "PackedPosition.h"
+#include "HistoryManager.h"
+#include "MoveCache.h"
+
+/**
+ * Distribution of latencies in microseconds, exact below 64 and with 8 buckets for every power of two above.
+ * Recorded from many threads without locks.
+ */
+class LatencyHistogram {
+private:
+    static constexpr size_t LINEAR_BUCKETS = 64;
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + (64 - 6) * SUB_BUCKETS;
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+
+    static size_t bucketOf(uint64_t microseconds);
+
+    static uint64_t upperBoundOf(size_t bucket);
+
+public:
+    void record(uint64_t microseconds);
+
+    uint64_t getCount() const;
+
+    /**
+     * Upper bound of the bucket in which the given fraction (0-1) of the recorded latencies ends, 0 if none were
+     * recorded
+     */
+    uint64_t percentile(double fraction) const;
+};
+
+struct SessionStats {
+    size_t games;
+    uint64_t moves;
+    uint64_t commands;
+    double uptimeSeconds;
+    double movesPerSecond;
+    uint64_t p99Microseconds;
+    /**
+     * Percentage of the legal move lists found in the cache
+     */
+    double cacheHitRate;
+};
+
+/**
+ * Many live games played through text commands. A game is kept between the commands in compact form - its packed
+ * position and the records of its moves - and rebuilt for the command which needs it.
+ *
+ * The sessions are split into shards by their ids, each with its own worker thread, which is the only one touching
+ * the sessions of the shard. The commands of a session are run one by one in the order they were given,
+ * the commands of different shards in parallel.
+ *
+ * Commands, the replies start with "ok" or "error <message>":
+ *  create [fen]       ok <id>
+ *  move <id> <move>   ok, the move in Smith notation, eg. e2e4 or e7e8q, if it is legal and the game is not over
+ *  moves <id>         ok <move> <move> ... - legal moves in Smith notation, promotions with each piece
+ *  status <id>        ok <playing|mate|stalemate|insufficient-material|fifty-move-rule|threefold-repetition> <w|b>
+ *  fen <id>           ok <fen>
+ *  close <id>         ok
+ *  stats              ok games=<n> moves=<n> commands=<n> uptime=<s> moves/s=<n> p99=<us>us cache=<%>%
+ *
+ * The moves per second are averaged since the start, the 99th percentile is of the time from giving a command
+ * to its reply. The legal moves of the positions met in the sessions are kept in a cache shared by the shards.
+ */
+class SessionManager {
+private:
+    struct Session {
+        PackedPosition position;
+        HistoryManager history;
+    };
+
+    struct Shard {
+        std::unordered_map<uint64_t, Session> sessions;
+        std::mutex queueMutex;
+        std::condition_variable queueChanged;
+        std::deque<std::function<void()>> queue;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<uint64_t> nextId{1};
+    std::atomic<size_t> games{0};
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> commands{0};
+    LatencyHistogram latencies;
+    MoveCache moveCache{MoveCache::DEFAULT_CAPACITY * 4};
+    std::chrono::steady_clock::time_point startTime;
+
+    static void runWorker(Shard &shard);
+
+    Shard &shardOf(uint64_t id);
+
+    /**
+     * Run the command on the session, on the worker of its shard
+     * @throws ChessException if the command fails
+     */
+    std::string runCommand(Shard &shard, const std::string &name, uint64_t id, const std::string &argument);
+
+    std::string formatStats() const;
+
+public:
+    /**
+     * @param shardCount number of shards and worker threads, at least one
+     */
+    explicit SessionManager(size_t shardCount);
+
+    /**
+     * Runs the commands which were already given and stops the workers
+     */
+    ~SessionManager();
+
+    SessionManager(const SessionManager &) = delete;
+
+    SessionManager &operator=(const SessionManager &) = delete;
+
+    /**
+     * Queue the command on the worker of its session's shard
+     * @return future reply, errors are replies too
+     */
+    std::future<std::string> execute(std::string_view command);
+
+    SessionStats getStats() const;
+
+    size_t getShardCount() const;
+};
+
+
+#endif //CHESS_SESSIONMANAGER_H
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "SlidingAttacks.h"
+#include "CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CHESS_PEXT_KERNEL
+#endif
+
+namespace {
+    constexpr int ROOK_DIRECTIONS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    constexpr int BISHOP_DIRECTIONS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+    /**
+     * Attacks walked ray by ray, used to fill the tables
+     */
+    Bitboard slowAttacks(Square square, Bitboard occupied, const int (&directions)[4][2]) {
+        Bitboard attacks = 0;
+        for (const auto &direction: directions) {
+            for (auto target = square.offset(direction[0], direction[1]);
+                 target.isValid(); target = target.offset(direction[0], direction[1])) {
+                attacks |= squareBit(target);
+                if (occupied & squareBit(target)) {
+                    break;
+                }
+            }
+        }
+        return attacks;
+    }
+
+    /**
+     * Fields whose occupancy affects the attacks - the rays without the edge fields they end on
+     */
+    Bitboard relevantOccupancy(Square square, const int (&directions)[4][2]) {
+        Bitboard mask = 0;
+        for (const auto &direction: directions) {
+            for (auto target = square.offset(direction[0], direction[1]);
+                 target.isValid() && target.offset(direction[0], direction[1]).isValid();
+                 target = target.offset(direction[0], direction[1])) {
+                mask |= squareBit(target);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * xorshift64*, seeded with constants so that the same magics are found on every run
+     */
+    class Random {
+    private:
+        uint64_t state;
+
+        uint64_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        }
+
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+
+        /**
+         * Number with few bits set, which makes a good magic candidate
+         */
+        uint64_t sparse() {
+            return next() & next() & next();
+        }
+    };
+
+    struct Magic {
+        Bitboard mask;
+        Bitboard magic;
+        unsigned shift;
+        Bitboard *attacks;
+
+        unsigned magicIndex(Bitboard occupied) const {
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+        }
+    };
+
+#ifdef CHESS_PEXT_KERNEL
+    __attribute__((target("bmi2"))) unsigned pextIndex(const Magic &entry, Bitboard occupied) {
+        return static_cast<unsigned>(_pext_u64(occupied, entry.mask));
+    }
+
+    __attribute__((target("bmi2"))) Bitboard pextAttacks(const Magic &entry, Bitboard occupied) {
+        return entry.attacks[_pext_u64(occupied, entry.mask)];
+    }
+
+    __attribute__((target("bmi2"))) Bitboard pextAttacks(const Magic &rook, const Magic &bishop, Bitboard occupied) {
+        return rook.attacks[_pext_u64(occupied, rook.mask)] | bishop.attacks[_pext_u64(occupied, bishop.mask)];
+    }
+#else
+    unsigned pextIndex(const Magic &, Bitboard) {
+        return 0;
+    }
+
+    Bitboard pextAttacks(const Magic &, Bitboard) {
+        return 0;
+    }
+
+    Bitboard pextAttacks(const Magic &, const Magic &, Bitboard) {
+        return 0;
+    }
+#endif
+
+    // seeds by rank of the field which find all magics after few attempts, taken from Stockfish
+    constexpr uint64_t SEEDS[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    class MagicTable {
+    private:
+        std::array<Magic, 64> magics{};
+        std::vector<Bitboard> attacks;
+
+    public:
+        /**
+         * @param usePext whether the table is indexed with PEXT instead of the magic multiplication
+         */
+        MagicTable(const int (&directions)[4][2], size_t tableSize, bool usePext) : attacks(tableSize) {
+            std::vector<Bitboard> occupancies;
+            std::vector<Bitboard> references;
+            std::vector<int> epochs;
+            int epoch = 0;
+            size_t offset = 0;
+
+            for (int index = 0; index < 64; index++) {
+                auto square = Square(index);
+                auto &entry = magics[index];
+                entry.mask = relevantOccupancy(square, directions);
+                entry.shift = 64 - __builtin_popcountll(entry.mask);
+                entry.attacks = attacks.data() + offset;
+
+                // every subset of the mask, enumerated with the Carry-Rippler trick
+                occupancies.clear();
+                references.clear();
+                Bitboard subset = 0;
+                do {
+                    occupancies.push_back(subset);
+                    references.push_back(slowAttacks(square, subset, directions));
+                    subset = (subset - entry.mask) & entry.mask;
+                } while (subset != 0);
+
+                if (usePext) {
+                    for (size_t i = 0; i < occupancies.size(); i++) {
+                        entry.attacks[pextIndex(entry, occupancies[i])] = references[i];
+                    }
+                    offset += occupancies.size();
+                    continue;
+                }
+
+                epochs.assign(occupancies.size(), 0);
+                Random random(SEEDS[square.getRank()]);
+                bool found = false;
+                while (!found) {
+                    entry.magic = random.sparse();
+                    if (__builtin_popcountll((entry.mask * entry.magic) >> 56) < 6) {
+                        continue;
+                    }
+                    epoch++;
+                    found = true;
+                    for (size_t i = 0; i < occupancies.size() && found; i++) {
+                        auto slot = entry.magicIndex(occupancies[i]);
+                        if (epochs[slot] < epoch) {
+                            epochs[slot] = epoch;
+                            entry.attacks[slot] = references[i];
+                        } else if (entry.attacks[slot] != references[i]) {
+                            found = false;
+                        }
+                    }
+                }
+                offset += occupancies.size();
+            }
+        }
+
+        const Magic &operator[](Square square) const {
+            return magics[square.getIndex()];
+        }
+    };
+
+    // sums of 2 ^ (number of relevant fields) over all fields
+    constexpr size_t ROOK_TABLE_SIZE = 102400;
+    constexpr size_t BISHOP_TABLE_SIZE = 5248;
+
+    /**
+     * Both tables with the way they are indexed, chosen together with building them, so that a lookup during
+     * static initialization of another translation unit cannot use an index the tables were not built for.
+     * With BMI2 the relevant occupancy bits are gathered into the index directly and no magic numbers are needed.
+     */
+    struct SlidingTables {
+        bool usePext;
+        MagicTable rook;
+        MagicTable bishop;
+
+        SlidingTables() : usePext(CpuFeatures::hasBmi2()),
+                          rook(ROOK_DIRECTIONS, ROOK_TABLE_SIZE, usePext),
+                          bishop(BISHOP_DIRECTIONS, BISHOP_TABLE_SIZE, usePext) {}
+    };
+
+    const SlidingTables &slidingTables() {
+        static const SlidingTables tables;
+        return tables;
+    }
+
+    // built while the library is loaded instead of during the first move generation
+    [[maybe_unused]] const bool tablesInitialized = (slidingTables(), true);
+}
+
+Bitboard SlidingAttacks::rookAttacks(Square square, Bitboard occupied) {
+    const auto &tables = slidingTables();
+    const auto &rook = tables.rook[square];
+    if (tables.usePext) {
+        return pextAttacks(rook, occupied);
+    }
+    return rook.attacks[rook.magicIndex(occupied)];
+}
+
+Bitboard SlidingAttacks::bishopAttacks(Square square, Bitboard occupied) {
+    const auto &tables = slidingTables();
+    const auto &bishop = tables.bishop[square];
+    if (tables.usePext) {
+        return pextAttacks(bishop, occupied);
+    }
+    return bishop.attacks[bishop.magicIndex(occupied)];
+}
+
+Bitboard SlidingAttacks::queenAttacks(Square square, Bitboard occupied) {
+    const auto &tables = slidingTables();
+    const auto &rook = tables.rook[square];
+    const auto &bishop = tables.bishop[square];
+    if (tables.usePext) {
+        return pextAttacks(rook, bishop, occupied);
+    }
+    return rook.attacks[rook.magicIndex(occupied)] | bishop.attacks[bishop.magicIndex(occupied)];
+}
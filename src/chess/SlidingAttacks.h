@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_SLIDINGATTACKS_H
+#define CHESS_SLIDINGATTACKS_H
+
+#include "Bitboard.h"
+
+/**
+ * Fields attacked by rooks, bishops and queens, looked up in magic bitboard tables
+ * https://www.chessprogramming.org/Magic_Bitboards
+ *
+ * The masks, magic numbers and attack tables are computed once, when the program starts. On processors with BMI2
+ * the tables are indexed with PEXT instead of the magic multiplication.
+ */
+class SlidingAttacks {
+public:
+    /**
+     * Fields attacked from the field along ranks and files, including the first occupied field in each direction
+     */
+    static Bitboard rookAttacks(Square square, Bitboard occupied);
+
+    /**
+     * Fields attacked from the field along diagonals, including the first occupied field in each direction
+     */
+    static Bitboard bishopAttacks(Square square, Bitboard occupied);
+
+    static Bitboard queenAttacks(Square square, Bitboard occupied);
+};
+
+
+#endif //CHESS_SLIDINGATTACKS_H
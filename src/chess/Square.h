@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_SQUARE_H
+#define CHESS_SQUARE_H
+
+#include <cstdint>
+
+/**
+ * Index of a field used internally by the engine, (rank * 8 + file) with rank and file counted from 0,
+ * a1 = 0, h8 = 63 - the same numbering as Position::getIndex. Never throws - going off the board gives
+ * an invalid square instead, checked with isValid. Position remains the checked type for user input.
+ */
+class Square {
+private:
+    uint8_t index;
+
+public:
+    static constexpr uint8_t NONE_INDEX = 64;
+
+    /**
+     * Invalid square
+     */
+    constexpr Square() : index(NONE_INDEX) {}
+
+    /**
+     * Small negative indices such as GameState::NO_EN_PASSANT and indices from 64 up give an invalid square
+     */
+    constexpr explicit Square(int index) : index(static_cast<uint8_t>(index)) {}
+
+    /**
+     * Square at the given rank and file counted from 0, invalid if outside the board
+     */
+    static constexpr Square at(int rank, int file) {
+        // a coordinate outside 0-7 has a bit set above the lowest three, negative ones included
+        auto onBoardMask = static_cast<uint8_t>(-static_cast<int>(((rank | file) & ~7) == 0));
+        auto squareIndex = static_cast<uint8_t>(rank * 8 + file);
+        return Square((squareIndex & onBoardMask) | (NONE_INDEX & ~onBoardMask));
+    }
+
+    constexpr int getIndex() const {
+        return index;
+    }
+
+    constexpr int getRank() const {
+        return index >> 3;
+    }
+
+    constexpr int getFile() const {
+        return index & 7;
+    }
+
+    constexpr bool isValid() const {
+        return index < 64;
+    }
+
+    /**
+     * Square shifted by the given number of ranks and files, invalid if it leaves the board
+     */
+    constexpr Square offset(int rankOffset, int fileOffset) const {
+        return at(getRank() + rankOffset, getFile() + fileOffset);
+    }
+
+    constexpr bool operator==(const Square &rhs) const {
+        return index == rhs.index;
+    }
+
+    constexpr bool operator!=(const Square &rhs) const {
+        return index != rhs.index;
+    }
+};
+
+static_assert(sizeof(Square) == 1, "Square must stay one byte large");
+static_assert(Square::at(0, 0).getIndex() == 0 && Square::at(7, 7).getIndex() == 63, "a1 = 0, h8 = 63");
+static_assert(!Square::at(-1, 3).isValid() && !Square::at(3, 8).isValid(), "off-board squares are invalid");
+static_assert(Square::at(1, 4).offset(2, -1) == Square::at(3, 3), "offsets move by ranks and files");
+
+
+#endif //CHESS_SQUARE_H
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "Zobrist.h"
+#include "Game.h"
+#include "GameState.h"
+#include "Board.h"
+#include "PieceCode.h"
+#include "Player.h"
+#include "Position.h"
+#include "Color.h"
+#include "constants.h"
+#include "pieces/Piece.h"
+#include "pieces/PieceType.h"
+
+uint64_t Zobrist::squareKey(const BoardSquares &squares, int square) {
+    if (squares[square] == NO_PIECE) {
+        return 0;
+    }
+    return Zobrist::pieceKey(pieceTypeOf(squares[square]), pieceColorOf(squares[square]), square);
+}
+
+uint64_t Zobrist::stateKey(const BoardSquares &squares, const GameState &state) {
+    uint64_t hash = 0;
+    static constexpr uint8_t rights[] = {GameState::WHITE_KINGSIDE, GameState::WHITE_QUEENSIDE,
+                                         GameState::BLACK_KINGSIDE, GameState::BLACK_QUEENSIDE};
+    for (int right = 0; right < 4; right++) {
+        if (state.hasCastlingRight(rights[right])) {
+            hash ^= Zobrist::castlingKey(right);
+        }
+    }
+
+    auto currentColor = state.sideToMove;
+    auto enPassantTarget = state.getEnPassantSquare();
+    if (enPassantTarget.isValid()) {
+        // the pawn which can be captured stands one rank behind the target field, from the capturing side
+        int pawnRankOffset = (currentColor == Color::WHITE) ? -1 : 1;
+        for (int fileOffset: {-1, 1}) {
+            auto square = enPassantTarget.offset(pawnRankOffset, fileOffset);
+            if (square.isValid() && squares[square.getIndex()] == makePieceCode(currentColor, PieceType::PAWN)) {
+                hash ^= Zobrist::enPassantKey(enPassantTarget.getFile() + 1);
+                break;
+            }
+        }
+    }
+
+    if (currentColor == Color::BLACK) {
+        hash ^= Zobrist::sideToMoveKey();
+    }
+    return hash;
+}
+
+uint64_t Zobrist::hash(const Game &game) {
+    uint64_t hash = 0;
+    const auto &squares = game.getBoard()->getSquares();
+    for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++) {
+        hash ^= Zobrist::squareKey(squares, square);
+    }
+    return hash ^ Zobrist::stateKey(squares, game.getGameState());
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#ifndef CHESS_ZOBRIST_H
+#define CHESS_ZOBRIST_H
+
+#include <cstdint>
+#include <array>
+#include <cstddef>
+#include "PieceCode.h"
+
+class Game;
+struct GameState;
+
+namespace ZobristKeys {
+    /**
+     * splitmix64 sequence with a fixed seed
+     */
+    template<size_t Count>
+    constexpr std::array<uint64_t, Count> generate() {
+        std::array<uint64_t, Count> keys{};
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto &key: keys) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }
+}
+
+/**
+ * Zobrist hashing of chess positions - xor of random keys of every piece on its field, castling rights,
+ * the en passant file and the side to move
+ * https://www.chessprogramming.org/Zobrist_Hashing
+ *
+ * The keys are generated at compile time from a fixed seed, hashes are stored in position index files
+ * and must not change between versions.
+ */
+class Zobrist {
+private:
+    static constexpr size_t pieceKeysCount = 2 * 6 * 64;
+    static constexpr size_t castlingKeysOffset = pieceKeysCount;
+    static constexpr size_t enPassantKeysOffset = castlingKeysOffset + 4;
+    static constexpr size_t sideToMoveKeyOffset = enPassantKeysOffset + 8;
+    static constexpr size_t keysCount = sideToMoveKeyOffset + 1;
+
+    static constexpr std::array<uint64_t, keysCount> keys = ZobristKeys::generate<keysCount>();
+
+public:
+    /**
+     * @param square index of the field, (row - 1) * 8 + (col - 1)
+     */
+    static constexpr uint64_t pieceKey(PieceType type, Color color, int square) {
+        return keys[(static_cast<int>(color) * 6 + static_cast<int>(type) - 1) * 64 + square];
+    }
+
+    /**
+     * @param castlingRight 0 - white kingside, 1 - white queenside, 2 - black kingside, 3 - black queenside
+     */
+    static constexpr uint64_t castlingKey(int castlingRight) {
+        return keys[castlingKeysOffset + castlingRight];
+    }
+
+    /**
+     * @param col column of the en passant target field, 1-8
+     */
+    static constexpr uint64_t enPassantKey(int col) {
+        return keys[enPassantKeysOffset + col - 1];
+    }
+
+    static constexpr uint64_t sideToMoveKey() {
+        return keys[sideToMoveKeyOffset];
+    }
+
+    /**
+     * Key of the piece on the field, 0 for an empty one
+     */
+    static uint64_t squareKey(const BoardSquares &squares, int square);
+
+    /**
+     * Part of the hash which does not come from the pieces - castling rights, the en passant file and the side
+     * to move. Kept apart so a move can update the hash by xoring out the old part and the fields it changes.
+     */
+    static uint64_t stateKey(const BoardSquares &squares, const GameState &state);
+
+    /**
+     * Hash of the current position of the game. The en passant file is included only if a pawn of the current
+     * player stands next to the pawn which can be captured en passant.
+     */
+    static uint64_t hash(const Game &game);
+};
+
+
+#endif //CHESS_ZOBRIST_H
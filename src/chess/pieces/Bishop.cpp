@@ -12,13 +12,6 @@
 #include <vector>
 
 
-std::vector<Move> Bishop::getMoves() const {
-    return this->getMovesInDirections({{1,  1},
-                                       {1,  -1},
-                                       {-1, 1},
-                                       {-1, -1}});
-}
-
 PieceType Bishop::getType() const {
     return PieceType::BISHOP;
 }
@@ -30,4 +23,4 @@ char Bishop::getCharacter() const {
 
 std::string Bishop::getUnicodeSymbol() const {
     return (color == Color::BLACK) ? "♝" : "♗";
-}
\ No newline at end of file
+}
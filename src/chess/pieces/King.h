@@ -8,11 +8,12 @@
 #ifndef CHESS_KING_H
 #define CHESS_KING_H
 
+#include <cstdint>
 #include <string>
 
 #include "Piece.h"
 
-enum class Color;
+enum class Color : uint8_t;
 class Player;
 class Field;
 class Move;
@@ -22,14 +23,9 @@ class Board;
 
 
 class King : public Piece {
-private:
-    std::vector<Position> getPossibleMovePositions() const;
-
 public:
     using Piece::Piece;
 
-    std::vector<Move> getMoves() const override;
-
     PieceType getType() const override;
 
     char getCharacter() const override;
@@ -14,16 +14,9 @@
 class Knight : public Piece {
 private:
 
-    /**
-     * Get all reachable positions on the board
-     */
-    std::vector<Position> getTargetPositions() const;
-
 public:
     using Piece::Piece;
 
-    std::vector<Move> getMoves() const override;
-
     PieceType getType() const override;
 
     char getCharacter() const override;
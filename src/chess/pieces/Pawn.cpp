@@ -10,22 +10,15 @@
 #include "../Color.h"
 #include "../Board.h"
 #include "Pawn.h"
-// TODO: Promotion mechanics
+#include "../MoveGenerator.h"
 
-Pawn::Pawn(Color color, Field *field) : Piece(color, field) {
+Pawn::Pawn(Color color, Field *field) : Piece(color, field), isEnPassantTarget(false) {
     this->moveDirection = (color == Color::WHITE) ? 1 : -1;
 }
 
 std::vector<Move> Pawn::getMoves() const {
-    std::vector<Move> moves = {};
-
-    // TODO: pins, checks?
-    std::vector<Move> captures = attackingMoves();
-    std::vector<Move> basicMoves = nonAttackingMoves();
-
-    moves.insert(moves.end(), captures.begin(), captures.end());
-    moves.insert(moves.end(), basicMoves.begin(), basicMoves.end());
-
+    std::vector<Move> moves;
+    MoveGenerator::generatePieceMoves(*getBoard(), getPosition().toSquare(), enPassantSquare(), moves);
     return moves;
 }
 
@@ -43,109 +36,26 @@ std::string Pawn::getUnicodeSymbol() const {
     return (color == Color::BLACK) ? "♟" : "♙";
 }
 
-bool Pawn::canMakeDoubleMove() const {
-    if ((this->parentField->getPosition().getRow() == 2 && this->color == Color::WHITE) ||
-        (this->parentField->getPosition().getRow() == 7 && this->color == Color::BLACK)) {
-        return true;
-    }
-    return false;
-}
-
-std::vector<Move> Pawn::nonAttackingMoves() const {
-    std::vector<Move> moves;
-    auto singleMoveToPosition = parentField->getPosition().positionWithOffset(moveDirection, 0);
-    bool possibleForwardMove = getBoard()->getField(singleMoveToPosition)->isEmpty();
-
-    // Single forward push
-    if (!possibleForwardMove) { return moves; }
-    moves.emplace_back(parentField->getPosition(), singleMoveToPosition, (Piece *) this);
-
-    // Double forward push
-    if (canMakeDoubleMove()) {
-        auto doubleMoveToPosition = parentField->getPosition().positionWithOffset(2 * moveDirection, 0);
-        if (getBoard()->getField(doubleMoveToPosition)->isEmpty()) {
-            moves.emplace_back(parentField->getPosition(), doubleMoveToPosition, (Piece *) this);
+Square Pawn::enPassantSquare() const {
+    auto square = getPosition().toSquare();
+    for (int fileOffset: {1, -1}) {
+        auto neighbourSquare = square.offset(0, fileOffset);
+        if (!neighbourSquare.isValid()) {
+            continue;
         }
-    }
-    return moves;
-}
-
-std::vector<Move> Pawn::attackingMoves() const {
-
-    std::vector<Move> moves;
-
-    // attack with a positive column offset
-    if (possibleAttackInGivenDirection(true)) {
-        auto toPosAfterAttack = parentField->getPosition().positionWithOffset(moveDirection, 1);
-        moves.emplace_back(parentField->getPosition(), toPosAfterAttack, (Piece *) this,
-                           this->getBoard()->getField(toPosAfterAttack)->getPiece());
-    }
-
-    if (possibleAttackInGivenDirection(false)) {
-        auto toPosAfterAttack = parentField->getPosition().positionWithOffset(moveDirection, -1);
-        moves.emplace_back(parentField->getPosition(), toPosAfterAttack, (Piece *) this,
-                           this->getBoard()->getField(toPosAfterAttack)->getPiece());
-    }
-
-    // check for en passant possibilities
-    if ((getPosition().getRow() == 5 && color == Color::WHITE) ||
-        (getPosition().getRow() == 4 && color == Color::BLACK)) {
-        auto EPMoves = enPassantMoves();
-        moves.insert(moves.end(), EPMoves.begin(), EPMoves.end());
-    }
-    return moves;
-}
-
-bool Pawn::possibleAttackInGivenDirection(bool positiveColumnOffset) const {
-    int horizontalMoveDirection = (positiveColumnOffset) ? 1 : -1;
-    auto position = this->getPosition();
-
-    if (!position.offsetWithinBounds(moveDirection, horizontalMoveDirection)) {
-        return false;
-    }
-
-    auto attackedPosition = position.positionWithOffset(moveDirection, horizontalMoveDirection);
-    auto attackedField = this->getBoard()->getField(attackedPosition);
-    if (attackedField->isEmpty()) {
-        return false;  // nothing to attack
-    }
-
-    if (attackedField->getPiece()->getColor() == this->getColor()) {
-        return false;
-    }
-
-    return true;
-}
-
-std::vector<Move> Pawn::enPassantMoves() const {
-    std::vector<Move> moves;
-    std::vector<std::pair<int, int>> enPassantOffsets = {{0, 1},
-                                                         {0, -1}};
-    auto enPassantPositions = getAllowedPositionsFromOffsets(enPassantOffsets);
-
-    for (auto ePPos: enPassantPositions) {
-        // check whether there is a pawn on the field
-        auto pieceAtField = dynamic_cast<Pawn *>(getBoard()->getField(ePPos)->getPiece());
-        if (!pieceAtField) { continue; }
-        if (pieceAtField->getColor() != color && pieceAtField->isEnPassantTarget) {
-            auto enPassantToPosition = Position(ePPos.getRow() + moveDirection, ePPos.getCol());
-            moves.push_back(Move(getPosition(), enPassantToPosition, (Piece *) this, pieceAtField));
+        auto neighbour = getBoard()->getPiece(neighbourSquare);
+        if (neighbour != nullptr && neighbour->getType() == PieceType::PAWN && neighbour->getColor() != color &&
+            static_cast<Pawn *>(neighbour)->isEnPassantTarget) {
+            return square.offset(moveDirection, fileOffset);
         }
     }
-    return moves;
-
+    return {};
 }
 
 void Pawn::setIsEnPassantTarget(bool valToSet) {
     isEnPassantTarget = valToSet;
 }
 
-std::vector<Position> Pawn::attackedPositions() const {
-    std::vector<std::pair<int, int>> offsetsOfAttackedFields = {{moveDirection, 1},
-                                                                {moveDirection, -1}};
-    return getAllowedPositionsFromOffsets(offsetsOfAttackedFields);
-}
-
 int Pawn::getMoveDirection() const {
     return moveDirection;
 }
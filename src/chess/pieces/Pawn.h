@@ -10,41 +10,26 @@
 #define CHESS_PAWN_H
 
 #include "Piece.h"
+#include "../Square.h"
 
 
 class Pawn : public Piece {
 private:
     int moveDirection;
 
-    /**
-     * Returns the bool equal to !(has pawn moved yet) - whether it can perform a double move
-     */
-    bool canMakeDoubleMove() const;
-
-    /**
-     * Boolean indicating whether an attacking a controlled field is possible
-     *
-     * @param positiveColumnOffset - indicates in which horizontal direction to look for an attack in
-     */
-    bool possibleAttackInGivenDirection(bool positiveColumnOffset) const;
-
-    /**
-     * Returns a vector of possible non-attacking moves (max. two moves - single and double push).
-     * Validates the board situation except checks and pins.
-     */
-    std::vector<Move> nonAttackingMoves() const;
+    bool isEnPassantTarget;
 
     /**
-     * Returns vector of possible attacking moves. Validates the board situation except checks and pins.
+     * Field behind an opponent's pawn next to this one which can be captured en passant, invalid if there is none
      */
-    std::vector<Move> attackingMoves() const;
-
-    bool isEnPassantTarget;
-
+    Square enPassantSquare() const;
 
 public:
     Pawn(Color color, Field *field);
 
+    /**
+     * Includes en passant captures of the neighbouring pawns marked as en passant targets
+     */
     std::vector<Move> getMoves() const override;
 
     PieceType getType() const override;
@@ -56,25 +41,9 @@ public:
     int getMoveDirection() const;
 
     /**
-     * Returns vector of possible en passant moves or empty if there are none.
-     * Validates the board situation except checks and pins.
-     * */
-    std::vector<Move> enPassantMoves() const;
-
-    /**
-     * Utility used when examined whether a king can castle - we need to check if a pawn attacks squares
-     * to castle through.
+     * Used to set the isEnPassantTarget param to a given bool
      * */
-    std::vector<Position> attackedPositions() const;
-
     void setIsEnPassantTarget(bool valToSet);
-    // TODO: delete this later, used for test purposes before implementing actual move mechanics
-    /**
-     * Used to set the isEnPassantTarget param to a given bool
-     * */;
-
-
-
 };
 
 
@@ -10,9 +10,10 @@
 
 
 #include <vector>
+#include <cstdint>
 #include <string>
 
-enum class Color;
+enum class Color : uint8_t;
 
 class Move;
 
@@ -29,35 +30,21 @@ class Position;
 class Move;
 
 class Piece {
-private:
-    /**
-     * Get moves in a straight line until another piece or edge of the board is reached
-     * arguments define the direction of the line
-     * @param rowDirection - {-1, 0, 1}
-     * @param colDirection - {-1, 0, 1}
-     */
-    virtual std::vector<Move> getMovesInDirection(int rowDirection, int colDirection) const;
-
 protected:
 
     Color color;
     Field *parentField;
-    /**
-     * Return moves in straight lines, stopping at board boundary, friendly piece or a capture
-     * in all of the given directions.
-     *
-     * Directions must have values from {-1, 0, 1}, eg. {1, -1} -> diagonally to upper-left
-     *
-     * @param directions vector of pairs {rowDirection, colDirection}
-     */
-    virtual std::vector<Move> getMovesInDirections(std::vector<std::pair<int, int>> const &directions) const;
 
 public:
     Piece(Color color, Field *field);
 
     virtual ~Piece() = default;
 
-    virtual std::vector<Move> getMoves() const = 0;
+    /**
+     * Moves of the piece not taking checks, pins and castling into account, generated from the piece codes
+     * of the board by MoveGenerator
+     */
+    virtual std::vector<Move> getMoves() const;
 
     virtual PieceType getType() const = 0;
 
@@ -76,8 +63,6 @@ public:
     virtual std::string getUnicodeSymbol() const = 0;
 
     virtual void takeOffField();
-
-    virtual std::vector<Position> getAllowedPositionsFromOffsets(const std::vector<std::pair<int, int>> &offsets) const;
 };
 
 
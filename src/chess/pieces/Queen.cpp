@@ -12,17 +12,6 @@
 #include "Queen.h"
 
 
-std::vector<Move> Queen::getMoves() const {
-    return this->getMovesInDirections({{1,  0},
-                                       {-1, 0},
-                                       {0,  1},
-                                       {0,  -1},
-                                       {1,  1},
-                                       {1,  -1},
-                                       {-1, 1},
-                                       {-1, -1}});
-}
-
 PieceType Queen::getType() const {
     return PieceType::QUEEN;
 }
@@ -12,13 +12,6 @@
 #include "Rook.h"
 
 
-std::vector<Move> Rook::getMoves() const {
-    return this->getMovesInDirections({{1,  0},
-                                       {-1, 0},
-                                       {0,  1},
-                                       {0,  -1}});
-}
-
 PieceType Rook::getType() const {
     return PieceType::ROOK;
 }
@@ -17,8 +17,6 @@ private:
 public:
     using Piece::Piece;
 
-    std::vector<Move> getMoves() const override;
-
     PieceType getType() const override;
 
     char getCharacter() const override;
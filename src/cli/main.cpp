@@ -6,7 +6,6 @@
  */
 
 #include <iostream>
-#include <algorithm>
 #include "Game.h"
 #include "Color.h"
 #include "Player.h"
@@ -18,6 +17,8 @@
 #include "StockfishBot.h"
 #include "pieces/Pawn.h"
 #include "FENParser.h"
+#include "GameOver.h"
+#include "MoveCache.h"
 
 
 bool handleIfSpecialCommand(const std::string &playerInput) {
@@ -38,6 +39,36 @@ std::string playerPrompt(const Game &game) {
 }
 
 
+/**
+ * Print the result if the game has ended
+ * @return whether the game is over
+ */
+bool announceIfGameOver(const Game &game) {
+    auto loser = (game.getCurrentPlayer()->getColor() == Color::WHITE) ? "White" : "Black";
+    auto winner = (game.getCurrentPlayer()->getColor() == Color::WHITE) ? "Black" : "White";
+    switch (game.isOver()) {
+        case GameOver::NOT_OVER:
+            return false;
+        case GameOver::MATE:
+            std::cout << "Checkmate! " << winner << " wins, " << loser << " is mated" << std::endl;
+            break;
+        case GameOver::STALEMATE:
+            std::cout << "Draw - stalemate" << std::endl;
+            break;
+        case GameOver::INSUFFICIENT_MATERIAL:
+            std::cout << "Draw - insufficient material" << std::endl;
+            break;
+        case GameOver::FIFTY_MOVE_RULE:
+            std::cout << "Draw - fifty move rule" << std::endl;
+            break;
+        case GameOver::THREEFOLD_REPETITION:
+            std::cout << "Draw - threefold repetition" << std::endl;
+            break;
+    }
+    std::cout << game.getBoard()->toString() << std::endl;
+    return true;
+}
+
 void processPlayerTurn(Game &game) {
     while (true) {
         std::cout << game.getBoard()->toString() << std::endl;
@@ -51,14 +82,15 @@ void processPlayerTurn(Game &game) {
 
         try {
             auto move = Move::parseSmithNotation(moveStr, game);
-            auto availableMoves = game.getMovesFrom(move.getFrom());
-
-            if (std::find(availableMoves.begin(), availableMoves.end(), move) == availableMoves.end()) {
+            if (!game.isLegal(move)) {
+                auto availableMoves = game.getLegalMovesFrom(move.getFrom());
                 std::cout << "Illegal move " << moveStr
                           << ", moves allowed from " << move.getFrom().toString() << ":" << std::endl;
 
                 for (const auto& availableMove: availableMoves) {
-                    std::cout << availableMove.toSmithNotation() << " ";
+                    for (const auto &choice: availableMove.withPromotionChoices()) {
+                        std::cout << choice.toSmithNotation() << " ";
+                    }
                 }
                 std::cout << std::endl;
                 continue;
@@ -84,7 +116,7 @@ void processBotTurn(Game &game, ChessBot &bot) {
 }
 
 void playPlayerVersusPlayer(Game &game) {
-    while (true) {
+    while (!announceIfGameOver(game)) {
         processPlayerTurn(game);
     }
 }
@@ -110,7 +142,7 @@ void playPlayerVersusComputer(Game &game) {
         }
     }
 
-    while (true) {
+    while (!announceIfGameOver(game)) {
         if (game.getCurrentPlayer()->getColor() == botColor) {
             processBotTurn(game, bot);
         } else {
@@ -129,6 +161,7 @@ Game initiateGame(int argc, char *argv[]) {
 
 int main(int argc, char *argv[]) {
     Game game = initiateGame(argc, argv);
+    game.setMoveCache(&MoveCache::shared());
 
     while (true) {
         std::string choice;
@@ -139,8 +172,10 @@ int main(int argc, char *argv[]) {
 
         if (choice[0] == '1') {
             playPlayerVersusPlayer(game);
+            break;
         } else if (choice[0] == '2') {
             playPlayerVersusComputer(game);
+            break;
         } else {
             std::cout << "Invalid command, choose either '1' or '2'" << std::endl;
             continue;
@@ -148,7 +183,6 @@ int main(int argc, char *argv[]) {
     }
 
     // TODO: give up command
-    // TODO: handle end of game
 
     return 0;
 }
@@ -10,15 +10,19 @@
 #include <vector>
 #include "Player.h"
 #include "FENParser.h"
+#include "MoveCache.h"
 
 GameHandler::GameHandler()
         : botGame(false), botColor(Color::BLACK), stockfishBot(nullptr) {
     game = new Game();
-
+    game->setMoveCache(&MoveCache::shared());
 }
 
 GameHandler::GameHandler(Game *game, bool BotGame, Color botColor)
         : game(game), botGame(BotGame), botColor(botColor) {
+    if (game != nullptr) {
+        game->setMoveCache(&MoveCache::shared());
+    }
     if (game != nullptr && BotGame) {
         stockfishBot = new StockfishBot(*game);
     } else {
@@ -43,6 +47,7 @@ const std::vector<Move> &GameHandler::getValidMoves() const {
 
 void GameHandler::clearMoves() {
     validMoves.clear();
+    selectedPosition.reset();
 }
 
 void GameHandler::makeMove(Move const *move) {
@@ -62,6 +67,7 @@ void GameHandler::newGame(bool botGame, Color bot_color, std::string const &fenN
     delete game;
 
     game = newGame;
+    game->setMoveCache(&MoveCache::shared());
     this->botGame = botGame;
     this->botColor = bot_color;
     if (botGame) {
@@ -75,7 +81,7 @@ void GameHandler::setBotDepth(int depth) {
 }
 
 void GameHandler::handleBotMove() {
-    if (botGame && botColor == game->getCurrentPlayer()->getColor()) {
+    if (botGame && botColor == game->getCurrentPlayer()->getColor() && game->isOver() == GameOver::NOT_OVER) {
 
         Move botMove = stockfishBot->getBestNextMove();
         game->makeMove(botMove);
@@ -100,6 +106,7 @@ bool GameHandler::isMate() {
 
 const std::vector<Move> &GameHandler::loadMovesFromPosition(Position position) {
     validMoves = game->getLegalMovesFrom(position);
+    selectedPosition = position;
     return validMoves;
 }
 
@@ -113,13 +120,16 @@ Color GameHandler::getCurrentPlayerColor() {
 
 
 Move *GameHandler::findMoveTo(const Position position) {
-    for (auto move: validMoves) {
-        Position goal = move.getTo();
-        if (goal == position) {
-            return new Move(move);
-        }
+    if (!selectedPosition.has_value() || game->getPiece(*selectedPosition) == nullptr) {
+        return nullptr;
+    }
+    auto move = Move::fromPositions(*game, *selectedPosition, position);
+    // the player chooses the promotion piece after the move is found
+    auto checkedMove = move;
+    if (move.resultsInPromotion()) {
+        checkedMove.setPromotion(PieceType::QUEEN);
     }
-    return nullptr;
+    return game->isLegal(checkedMove) ? new Move(move) : nullptr;
 }
 
 bool GameHandler::fieldBelongsToCurrent(Position position) {
@@ -10,6 +10,7 @@
 #define CHESS_GAMEHANDLER_H
 
 #include <vector>
+#include <optional>
 #include "ClickableLabel.h"
 #include "Game.h"
 #include "pieces/PieceType.h"
@@ -27,6 +28,10 @@ class GameHandler {
 private:
     Game *game;
     std::vector<Move> validMoves;
+    /**
+     * Field of the piece whose moves are being considered
+     */
+    std::optional<Position> selectedPosition;
     bool botGame;
     ChessBot *stockfishBot;
     Color botColor;
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <string>
+#include "Game.h"
+#include "Move.h"
+#include "FENParser.h"
+#include "PackedPosition.h"
+#include "GameOver.h"
+#include "Board.h"
+#include "SlidingAttacks.h"
+#include "CpuFeatures.h"
+
+/**
+ * Positions covering castling, en passant, promotions and checks
+ */
+const std::vector<std::string> BENCHMARK_POSITIONS = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+/**
+ * Run the task repeatedly for at least the given time and print the average time of a single run
+ */
+void benchmark(const std::string &name, double minimumSeconds, const std::function<size_t()> &task) {
+    size_t runs = 0;
+    size_t operations = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    double elapsed;
+    do {
+        operations += task();
+        runs++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    } while (elapsed < minimumSeconds);
+
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+              << elapsed * 1e6 / runs << " us/run"
+              << std::setw(12) << std::setprecision(0) << operations / elapsed << " ops/s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    double minimumSeconds = (argc > 1) ? std::atof(argv[1]) : 2.0;
+
+    std::cout << "cpu features: " << CpuFeatures::describe() << std::endl;
+
+    std::vector<std::unique_ptr<Game>> games;
+    for (const auto &fen: BENCHMARK_POSITIONS) {
+        games.emplace_back(new Game(FENParser::parseGame(fen)));
+    }
+
+    benchmark("legal moves", minimumSeconds, [&games]() {
+        size_t moves = 0;
+        for (auto &game: games) {
+            moves += game->getLegalMovesForPlayer(game->getCurrentPlayer()).size();
+        }
+        return moves;
+    });
+
+    benchmark("make/undo legal moves", minimumSeconds, [&games]() {
+        size_t moves = 0;
+        for (auto &game: games) {
+            for (const auto &move: game->getLegalMovesForPlayer(game->getCurrentPlayer())) {
+                game->makeMove(move);
+                game->undoMove();
+                moves++;
+            }
+        }
+        return moves;
+    });
+
+    benchmark("perft 3", minimumSeconds, [&games]() {
+        size_t nodes = 0;
+        for (auto &game: games) {
+            nodes += game->perft(3);
+        }
+        return nodes;
+    });
+
+    benchmark("parse FEN", minimumSeconds, []() {
+        CompactPosition position{};
+        size_t parsed = 0;
+        for (const auto &fen: BENCHMARK_POSITIONS) {
+            parsed += FENParser::parsePosition(fen, position) ? 0 : 1;
+        }
+        return parsed;
+    });
+
+    benchmark("write FEN", minimumSeconds, [&games]() {
+        FENParser::FenBuffer buffer;
+        size_t written = 0;
+        for (auto &game: games) {
+            written += (FENParser::writeGame(*game, buffer) > 0) ? 1 : 0;
+        }
+        return written;
+    });
+
+    std::vector<PackedPosition> packedPositions;
+    for (auto &game: games) {
+        packedPositions.push_back(PackedPosition::fromGame(*game));
+    }
+    benchmark("unpack position", minimumSeconds, [&packedPositions]() {
+        size_t unpacked = 0;
+        for (const auto &packed: packedPositions) {
+            unpacked += (packed.unpack().state.fullmoveNumber > 0) ? 1 : 0;
+        }
+        return unpacked;
+    });
+
+    benchmark("sliding attacks", minimumSeconds, [&games]() {
+        Bitboard attacked = 0;
+        for (auto &game: games) {
+            auto occupied = game->getBoard()->getOccupied();
+            for (int index = 0; index < 64; index++) {
+                attacked ^= SlidingAttacks::queenAttacks(Square(index), occupied);
+            }
+        }
+        return 64 * games.size() + (attacked & 1);
+    });
+
+    benchmark("game status", minimumSeconds, [&games]() {
+        size_t positions = 0;
+        for (auto &game: games) {
+            game->switchCurrentPlayer();
+            game->switchCurrentPlayer();
+            positions += (game->isOver() == GameOver::NOT_OVER) ? 1 : 0;
+        }
+        return positions;
+    });
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <charconv>
+#include <vector>
+#include <string>
+#include "Game.h"
+#include "Move.h"
+#include "PGNParser.h"
+#include "EpdReader.h"
+#include "PackedPosition.h"
+#include "ChessExceptions.h"
+
+
+void printUsage(const char *programName) {
+    std::cerr << "Usage:" << std::endl
+              << "  " << programName << " perft <in.epd> [max depth] [threads]    verify the D1, D2, ... node counts"
+              << std::endl
+              << "  " << programName << " check <in.epd> [threads]                verify the positions and bm/am moves"
+              << std::endl
+              << "  " << programName << " pack <in.epd> <out.cpos> [threads]      convert the positions to 32 bytes each"
+              << std::endl;
+}
+
+size_t threadCountArgument(int argc, char *argv[], int position) {
+    if (argc > position) {
+        return std::max(1, std::atoi(argv[position]));
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Results of the records of a single chunk, written only by the thread which parses it
+ */
+struct ChunkReport {
+    size_t records = 0;
+    size_t invalidRecords = 0;
+    size_t checks = 0;
+    size_t failedChecks = 0;
+    std::vector<std::string> messages;
+
+    void fail(const EpdRecord &record, const std::string &message) {
+        auto id = record.getOperation("id");
+        messages.push_back(std::string(id ? *id : record.line) + ": " + message);
+    }
+};
+
+/**
+ * Parse the file on all threads and print the failures in the order of the chunks together with the totals
+ */
+int run(const std::string &inputPath, size_t threadCount, const std::string &checkName,
+        const std::function<void(const EpdRecord &, ChunkReport &)> &check) {
+    EpdReader reader(inputPath);
+    std::vector<ChunkReport> reports(std::max<size_t>(1, threadCount));
+
+    auto startTime = std::chrono::steady_clock::now();
+    reader.forEachRecordParallel(threadCount, [&](const EpdRecord &record, size_t chunk) {
+        auto &report = reports[chunk];
+        report.records++;
+        if (record.error) {
+            report.invalidRecords++;
+            report.fail(record, "invalid position at character " + std::to_string(record.error.offset) + " - " +
+                                record.error.message);
+            return;
+        }
+        check(record, report);
+    });
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    ChunkReport total;
+    for (const auto &report: reports) {
+        for (const auto &message: report.messages) {
+            std::cout << message << std::endl;
+        }
+        total.records += report.records;
+        total.invalidRecords += report.invalidRecords;
+        total.checks += report.checks;
+        total.failedChecks += report.failedChecks;
+    }
+    std::cout << "Read " << total.records << " records (" << total.invalidRecords << " invalid), "
+              << total.checks << " " << checkName << " (" << total.failedChecks << " failed) in "
+              << elapsed << " s using " << threadCount << " threads" << std::endl;
+    return (total.invalidRecords == 0 && total.failedChecks == 0) ? 0 : 1;
+}
+
+/**
+ * Perft suites keep the expected node counts as operations named after the depth, eg. ;D1 20 ;D2 400
+ */
+int perft(const std::string &inputPath, int maxDepth, size_t threadCount) {
+    return run(inputPath, threadCount, "perft counts", [maxDepth](const EpdRecord &record, ChunkReport &report) {
+        record.forEachOperation([&](std::string_view opcode, std::string_view operands) {
+            int depth = 0;
+            size_t expected = 0;
+            if (opcode.size() < 2 || opcode.front() != 'D' ||
+                std::from_chars(opcode.data() + 1, opcode.data() + opcode.size(), depth).ec != std::errc() ||
+                std::from_chars(operands.data(), operands.data() + operands.size(), expected).ec != std::errc() ||
+                depth > maxDepth) {
+                return;
+            }
+            Game game(record.position);
+            auto nodes = game.perft(depth);
+            report.checks++;
+            if (nodes != expected) {
+                report.failedChecks++;
+                report.fail(record, "perft " + std::to_string(depth) + " is " + std::to_string(nodes) +
+                                    ", expected " + std::to_string(expected));
+            }
+        });
+    });
+}
+
+/**
+ * Tactical suites list the best (bm) and avoided (am) moves in standard algebraic notation, all of them have to be
+ * legal in the position
+ */
+int check(const std::string &inputPath, size_t threadCount) {
+    return run(inputPath, threadCount, "moves", [](const EpdRecord &record, ChunkReport &report) {
+        Game game(record.position);
+        record.forEachOperation([&](std::string_view opcode, std::string_view operands) {
+            if (opcode != "bm" && opcode != "am") {
+                return;
+            }
+            size_t offset = 0;
+            while (offset < operands.size()) {
+                auto end = std::min(operands.find(' ', offset), operands.size());
+                if (end > offset) {
+                    std::string san(operands.substr(offset, end - offset));
+                    report.checks++;
+                    try {
+                        PGNParser::parseSan(san, game);
+                    } catch (const IllegalMoveException &e) {
+                        report.failedChecks++;
+                        report.fail(record, std::string(opcode) + " " + san + " is not a legal move");
+                    }
+                }
+                offset = end + 1;
+            }
+        });
+    });
+}
+
+/**
+ * Positions are parsed in parallel and written in the order of the file, invalid records are skipped
+ */
+int pack(const std::string &inputPath, const std::string &outputPath, size_t threadCount) {
+    EpdReader reader(inputPath);
+    std::vector<std::vector<CompactPosition>> positions(std::max<size_t>(1, threadCount));
+    std::vector<size_t> skipped(positions.size());
+
+    auto startTime = std::chrono::steady_clock::now();
+    reader.forEachRecordParallel(threadCount, [&](const EpdRecord &record, size_t chunk) {
+        if (record.error) {
+            skipped[chunk]++;
+            return;
+        }
+        positions[chunk].push_back(record.position);
+    });
+
+    PackedPositionWriter writer(outputPath);
+    size_t skippedRecords = 0;
+    for (size_t chunk = 0; chunk < positions.size(); chunk++) {
+        for (const auto &position: positions[chunk]) {
+            writer.add(position);
+        }
+        skippedRecords += skipped[chunk];
+    }
+    writer.close();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Packed " << writer.getCount() << " positions, skipped " << skippedRecords << " invalid records in "
+              << elapsed << " s" << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    try {
+        if (command == "perft" && argc <= 5) {
+            return perft(argv[2], (argc > 3) ? std::atoi(argv[3]) : 4, threadCountArgument(argc, argv, 4));
+        } else if (command == "check" && argc <= 4) {
+            return check(argv[2], threadCountArgument(argc, argv, 3));
+        } else if (command == "pack" && (argc == 4 || argc == 5)) {
+            return pack(argv[2], argv[3], threadCountArgument(argc, argv, 4));
+        }
+    } catch (const ChessException &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    printUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <random>
+#include <stdexcept>
+#include <memory>
+#include <vector>
+#include <string>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "SessionManager.h"
+
+
+void printUsage(const char *programName) {
+    std::cerr << "Usage:" << std::endl
+              << "  " << programName << " serve <socket> [workers]                       host games on the socket"
+              << std::endl
+              << "  " << programName << " load <socket> [connections] [games] [seconds]   play random games"
+              << std::endl;
+}
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+sockaddr_un socketAddress(const std::string &path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+bool writeAll(int fd, const std::string &data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        auto result = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+/**
+ * Client connection of the server, served by its own thread
+ */
+struct ServerConnection {
+    int fd;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+
+    explicit ServerConnection(int fd) : fd(fd) {}
+};
+
+/**
+ * Run the commands of the connection, one per line. The commands which arrive together are given to the session
+ * manager at once, so they run in parallel if their sessions are in different shards, and are replied to in order.
+ */
+void serveConnection(ServerConnection &connection, SessionManager &manager) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+        auto received = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        buffer.append(chunk, received);
+
+        std::vector<std::future<std::string>> replies;
+        size_t lineStart = 0;
+        size_t lineEnd;
+        while ((lineEnd = buffer.find('\n', lineStart)) != std::string::npos) {
+            std::string_view line(buffer.data() + lineStart, lineEnd - lineStart);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            replies.push_back(manager.execute(line));
+            lineStart = lineEnd + 1;
+        }
+        buffer.erase(0, lineStart);
+
+        std::string output;
+        for (auto &reply: replies) {
+            output += reply.get();
+            output += '\n';
+        }
+        if (!writeAll(connection.fd, output)) {
+            break;
+        }
+    }
+    connection.finished = true;
+}
+
+int serve(const std::string &path, size_t workers) {
+    auto address = socketAddress(path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        throw std::runtime_error("Cannot listen on " + path + ": " + strerror(errno));
+    }
+
+    struct sigaction action{};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    SessionManager manager(workers);
+    std::cerr << "serving on " << path << " with " << manager.getShardCount() << " workers" << std::endl;
+    std::vector<std::unique_ptr<ServerConnection>> connections;
+    auto lastReport = std::chrono::steady_clock::now();
+    uint64_t lastMoves = 0;
+    while (!stopRequested) {
+        pollfd listening{listener, POLLIN, 0};
+        if (poll(&listening, 1, 1000) > 0) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                auto connection = std::make_unique<ServerConnection>(fd);
+                connection->thread = std::thread(serveConnection, std::ref(*connection), std::ref(manager));
+                connections.push_back(std::move(connection));
+            }
+        }
+
+        // the threads of the closed connections are joined and their sockets closed
+        for (auto it = connections.begin(); it != connections.end();) {
+            if ((*it)->finished) {
+                (*it)->thread.join();
+                close((*it)->fd);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(5)) {
+            // reported only while games are being played
+            auto moves = manager.getStats().moves;
+            if (moves != lastMoves) {
+                std::cerr << manager.execute("stats").get().substr(3) << std::endl;
+            }
+            lastMoves = moves;
+            lastReport = now;
+        }
+    }
+
+    for (auto &connection: connections) {
+        shutdown(connection->fd, SHUT_RDWR);
+        connection->thread.join();
+        close(connection->fd);
+    }
+    close(listener);
+    unlink(path.c_str());
+    std::cerr << manager.execute("stats").get().substr(3) << std::endl;
+    return 0;
+}
+
+/**
+ * Connection of the load generator, which waits for the reply to every command
+ */
+class ClientConnection {
+private:
+    int fd;
+    std::string buffer;
+
+public:
+    explicit ClientConnection(const std::string &path) {
+        auto address = socketAddress(path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+            auto message = std::string("Cannot connect to ") + path + ": " + strerror(errno);
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::runtime_error(message);
+        }
+    }
+
+    ~ClientConnection() {
+        close(fd);
+    }
+
+    ClientConnection(const ClientConnection &) = delete;
+
+    ClientConnection &operator=(const ClientConnection &) = delete;
+
+    std::string request(const std::string &command) {
+        if (!writeAll(fd, command + "\n")) {
+            throw std::runtime_error("Connection closed by the server");
+        }
+        size_t lineEnd;
+        while ((lineEnd = buffer.find('\n')) == std::string::npos) {
+            char chunk[4096];
+            auto received = recv(fd, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                throw std::runtime_error("Connection closed by the server");
+            }
+            buffer.append(chunk, received);
+        }
+        auto reply = buffer.substr(0, lineEnd);
+        buffer.erase(0, lineEnd + 1);
+        return reply;
+    }
+};
+
+struct LoadReport {
+    uint64_t commands = 0;
+    uint64_t moves = 0;
+    uint64_t finishedGames = 0;
+};
+
+/**
+ * Play random moves in the games of the connection in turns, replacing the finished games with new ones
+ */
+void playRandomGames(const std::string &path, size_t games, std::chrono::steady_clock::time_point deadline,
+                     unsigned seed, LatencyHistogram &latencies, LoadReport &report) {
+    ClientConnection connection(path);
+    std::mt19937 random(seed);
+    auto request = [&](const std::string &command) {
+        auto start = std::chrono::steady_clock::now();
+        auto reply = connection.request(command);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latencies.record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        report.commands++;
+        return reply;
+    };
+    auto create = [&]() {
+        auto reply = request("create");
+        if (reply.rfind("ok ", 0) != 0) {
+            throw std::runtime_error("Cannot create a game: " + reply);
+        }
+        return reply.substr(3);
+    };
+
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < games; i++) {
+        ids.push_back(create());
+    }
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (auto &id: ids) {
+            auto moves = request("moves " + id);
+            // the moves are 4 or 5 characters long, separated by spaces
+            std::vector<std::string> legalMoves;
+            for (size_t start = 3; start < moves.size();) {
+                auto end = std::min(moves.find(' ', start), moves.size());
+                legalMoves.push_back(moves.substr(start, end - start));
+                start = end + 1;
+            }
+            if (!legalMoves.empty()) {
+                auto move = legalMoves[std::uniform_int_distribution<size_t>(0, legalMoves.size() - 1)(random)];
+                if (request("move " + id + " " + move) == "ok") {
+                    report.moves++;
+                    continue;
+                }
+            }
+            report.finishedGames++;
+            request("close " + id);
+            id = create();
+        }
+    }
+    for (const auto &id: ids) {
+        request("close " + id);
+    }
+}
+
+int load(const std::string &path, size_t connectionCount, size_t games, double seconds) {
+    LatencyHistogram latencies;
+    std::vector<LoadReport> reports(connectionCount);
+    std::vector<std::thread> threads;
+    std::vector<std::string> errors(connectionCount);
+    auto startTime = std::chrono::steady_clock::now();
+    auto deadline = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(seconds));
+    for (size_t i = 0; i < connectionCount; i++) {
+        threads.emplace_back([&, i]() {
+            try {
+                playRandomGames(path, games, deadline, i, latencies, reports[i]);
+            } catch (const std::exception &e) {
+                errors[i] = e.what();
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    LoadReport total;
+    for (size_t i = 0; i < connectionCount; i++) {
+        if (!errors[i].empty()) {
+            std::cerr << "connection " << i << ": " << errors[i] << std::endl;
+        }
+        total.commands += reports[i].commands;
+        total.moves += reports[i].moves;
+        total.finishedGames += reports[i].finishedGames;
+    }
+    std::cout << "games hosted: " << connectionCount * games << " on " << connectionCount << " connections"
+              << std::endl
+              << "finished games: " << total.finishedGames << std::endl
+              << "commands: " << total.commands << " (" << static_cast<uint64_t>(total.commands / elapsed) << "/s)"
+              << std::endl
+              << "moves: " << total.moves << " (" << static_cast<uint64_t>(total.moves / elapsed) << "/s)"
+              << std::endl
+              << "latency: p50 " << latencies.percentile(0.5) << " us, p99 " << latencies.percentile(0.99) << " us"
+              << std::endl;
+    try {
+        ClientConnection connection(path);
+        std::cout << "server: " << connection.request("stats").substr(3) << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+    }
+    for (const auto &error: errors) {
+        if (!error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    try {
+        if (command == "serve" && argc <= 4) {
+            auto workers = (argc > 3) ? std::max(1, std::atoi(argv[3]))
+                                      : std::max(1u, std::thread::hardware_concurrency());
+            return serve(argv[2], workers);
+        } else if (command == "load" && argc <= 6) {
+            auto connections = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 8;
+            auto games = (argc > 4) ? std::max(1, std::atoi(argv[4])) : 100;
+            auto seconds = (argc > 5) ? std::atof(argv[5]) : 10.0;
+            return load(argv[2], connections, games, seconds);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    printUsage(argv[0]);
+    return 2;
+}
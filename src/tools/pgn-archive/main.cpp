@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include "Game.h"
+#include "PGNParser.h"
+#include "GameArchive.h"
+#include "ChessExceptions.h"
+
+
+void printUsage(const char *programName) {
+    std::cerr << "Usage:" << std::endl
+              << "  " << programName << " pack <in.pgn> <out.cga> [threads]   convert PGN to a binary archive" << std::endl
+              << "  " << programName << " unpack <in.cga> <out.pgn>          convert a binary archive to PGN" << std::endl
+              << "  " << programName << " show <in.cga> <game number>        print a single game as PGN" << std::endl
+              << "  " << programName << " replay <in.cga> [threads]          replay all games, measure decoding speed"
+              << std::endl;
+}
+
+size_t threadCountArgument(int argc, char *argv[], int position) {
+    if (argc > position) {
+        return std::max(1, std::atoi(argv[position]));
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Call the task for every index in [0, count), split into contiguous shards between the threads
+ */
+void parallelFor(size_t count, size_t threadCount, const std::function<void(size_t)> &task) {
+    threadCount = std::max<size_t>(1, std::min(threadCount, count));
+    std::vector<std::thread> workers;
+    for (size_t shard = 0; shard < threadCount; shard++) {
+        workers.emplace_back([&task, begin = count * shard / threadCount, end = count * (shard + 1) / threadCount]() {
+            for (size_t i = begin; i < end; i++) {
+                task(i);
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+int pack(const std::string &inputPath, const std::string &outputPath, size_t threadCount) {
+    std::ifstream file(inputPath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << inputPath << std::endl;
+        return 2;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    auto contents = buffer.str();
+
+    auto games = PGNParser::splitGames(contents);
+    std::vector<ArchivedGame> archivedGames(games.size());
+    std::vector<std::string> errors(games.size());
+
+    parallelFor(games.size(), threadCount, [&](size_t i) {
+        try {
+            archivedGames[i] = GameArchive::fromPgn(PGNParser::parseGame(games[i]));
+        } catch (const std::exception &e) {
+            errors[i] = e.what();
+        }
+    });
+
+    GameArchiveWriter writer(outputPath);
+    size_t skippedGames = 0;
+    for (size_t i = 0; i < games.size(); i++) {
+        if (!errors[i].empty()) {
+            std::cerr << "Skipping game " << i + 1 << ": " << errors[i] << std::endl;
+            skippedGames++;
+            continue;
+        }
+        writer.addGame(archivedGames[i]);
+    }
+    writer.close();
+
+    std::cout << "Packed " << games.size() - skippedGames << " games, skipped " << skippedGames << std::endl;
+    return 0;
+}
+
+int unpack(const std::string &inputPath, const std::string &outputPath) {
+    GameArchiveReader reader(inputPath);
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cerr << "Cannot open " << outputPath << " for writing" << std::endl;
+        return 2;
+    }
+
+    for (size_t i = 0; i < reader.getGameCount(); i++) {
+        if (i > 0) {
+            output << '\n';
+        }
+        output << PGNParser::gameToString(GameArchive::toPgn(reader.getGame(i)));
+    }
+    std::cout << "Unpacked " << reader.getGameCount() << " games" << std::endl;
+    return 0;
+}
+
+int show(const std::string &inputPath, size_t gameNumber) {
+    GameArchiveReader reader(inputPath);
+    if (gameNumber < 1 || gameNumber > reader.getGameCount()) {
+        std::cerr << "Game number must be between 1 and " << reader.getGameCount() << std::endl;
+        return 2;
+    }
+    std::cout << PGNParser::gameToString(GameArchive::toPgn(reader.getGame(gameNumber - 1)));
+    return 0;
+}
+
+int replay(const std::string &inputPath, size_t threadCount) {
+    GameArchiveReader reader(inputPath);
+    std::atomic<size_t> plies = 0;
+    std::atomic<size_t> failedGames = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    parallelFor(reader.getGameCount(), threadCount, [&](size_t i) {
+        try {
+            size_t gamePlies = 0;
+            GameArchive::replay(reader.getGame(i), [&gamePlies](const Game &, size_t ply) {
+                gamePlies = ply;
+            });
+            plies += gamePlies;
+        } catch (const std::exception &e) {
+            failedGames++;
+        }
+    });
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Replayed " << reader.getGameCount() << " games (" << plies << " plies, " << failedGames
+              << " failed) in " << elapsed << " s, "
+              << ((elapsed > 0) ? reader.getGameCount() * 60 / elapsed : 0) << " games/min" << std::endl;
+    return (failedGames == 0) ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    try {
+        if (command == "pack" && (argc == 4 || argc == 5)) {
+            return pack(argv[2], argv[3], threadCountArgument(argc, argv, 4));
+        } else if (command == "unpack" && argc == 4) {
+            return unpack(argv[2], argv[3]);
+        } else if (command == "show" && argc == 4) {
+            return show(argv[2], std::strtoul(argv[3], nullptr, 10));
+        } else if (command == "replay" && (argc == 3 || argc == 4)) {
+            return replay(argv[2], threadCountArgument(argc, argv, 3));
+        }
+    } catch (const ChessException &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    printUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include "PGNParser.h"
+#include "PgnValidator.h"
+
+/**
+ * Split the games into contiguous shards of similar size in bytes, one per worker
+ */
+std::vector<size_t> shardBoundaries(const std::vector<std::string_view> &games, size_t shardCount) {
+    size_t totalSize = 0;
+    for (auto game: games) {
+        totalSize += game.size();
+    }
+
+    std::vector<size_t> boundaries = {0};
+    size_t accumulatedSize = 0;
+    for (size_t i = 0; i < games.size(); i++) {
+        accumulatedSize += games[i].size();
+        if (accumulatedSize * shardCount >= totalSize * boundaries.size() && boundaries.size() < shardCount) {
+            boundaries.push_back(i + 1);
+        }
+    }
+    boundaries.push_back(games.size());
+    return boundaries;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <file.pgn> [threads]" << std::endl;
+        return 2;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 2;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    auto contents = buffer.str();
+
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (argc == 3) {
+        threadCount = std::max(1, std::atoi(argv[2]));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    auto games = PGNParser::splitGames(contents);
+    threadCount = std::max<size_t>(1, std::min(threadCount, games.size()));
+    std::vector<GameReport> reports(games.size());
+
+    auto boundaries = shardBoundaries(games, threadCount);
+    std::vector<std::thread> workers;
+    for (size_t shard = 0; shard + 1 < boundaries.size(); shard++) {
+        workers.emplace_back([&games, &reports, begin = boundaries[shard], end = boundaries[shard + 1]]() {
+            for (size_t i = begin; i < end; i++) {
+                reports[i] = PgnValidator::validateGame(games[i]);
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t invalidGames = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        const auto &report = reports[i];
+        if (report.error == ValidationError::NONE) {
+            continue;
+        }
+        invalidGames++;
+        std::cout << "Game " << i + 1;
+        if (!report.players.empty()) {
+            std::cout << " (" << report.players << ")";
+        }
+        std::cout << ": " << PgnValidator::errorName(report.error) << ": " << report.detail << std::endl;
+    }
+
+    std::cout << "Validated " << games.size() << " games (" << invalidGames << " invalid) in "
+              << elapsed << " s using " << threadCount << " threads, "
+              << ((elapsed > 0) ? games.size() / elapsed : 0) << " games/s" << std::endl;
+
+    return (invalidGames == 0) ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include "Game.h"
+#include "GameArchive.h"
+#include "PositionIndex.h"
+#include "Zobrist.h"
+#include "ChessExceptions.h"
+
+/**
+ * Number of games replayed in parallel before their positions are handed to the builder
+ */
+const size_t BATCH_SIZE = 4096;
+
+void printUsage(const char *programName) {
+    std::cerr << "Usage:" << std::endl
+              << "  " << programName << " build <in.cga> <out.cpi> [threads]   index every position of the archive"
+              << std::endl
+              << "  " << programName << " query <in.cpi> <fen> [in.cga]       list games reaching the position"
+              << std::endl;
+}
+
+size_t threadCountArgument(int argc, char *argv[], int position) {
+    if (argc > position) {
+        return std::max(1, std::atoi(argv[position]));
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+int build(const std::string &archivePath, const std::string &indexPath, size_t threadCount) {
+    GameArchiveReader reader(archivePath);
+    PositionIndexBuilder builder(indexPath);
+    size_t failedGames = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t batchStart = 0; batchStart < reader.getGameCount(); batchStart += BATCH_SIZE) {
+        auto batchSize = std::min(BATCH_SIZE, reader.getGameCount() - batchStart);
+        std::vector<std::vector<uint64_t>> hashes(batchSize);
+        std::vector<bool> failed(batchSize, false);
+
+        auto shards = std::max<size_t>(1, std::min(threadCount, batchSize));
+        std::vector<std::thread> workers;
+        for (size_t shard = 0; shard < shards; shard++) {
+            workers.emplace_back([&, begin = batchSize * shard / shards, end = batchSize * (shard + 1) / shards]() {
+                for (size_t i = begin; i < end; i++) {
+                    try {
+                        auto &gameHashes = hashes[i];
+                        GameArchive::replay(reader.getGame(batchStart + i), [&gameHashes](const Game &game, size_t) {
+                            gameHashes.push_back(Zobrist::hash(game));
+                        });
+                    } catch (const std::exception &e) {
+                        hashes[i].clear();
+                        failed[i] = true;
+                    }
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+
+        for (size_t i = 0; i < batchSize; i++) {
+            if (failed[i]) {
+                std::cerr << "Skipping game " << batchStart + i + 1 << std::endl;
+                failedGames++;
+                continue;
+            }
+            for (size_t ply = 0; ply < hashes[i].size(); ply++) {
+                builder.addPosition(hashes[i][ply], batchStart + i, ply);
+            }
+        }
+    }
+    builder.finish();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    PositionIndexReader index(indexPath);
+    std::cout << "Indexed " << index.getPostingCount() << " positions (" << index.getPositionCount()
+              << " distinct) from " << reader.getGameCount() - failedGames << " games in " << elapsed << " s"
+              << std::endl;
+    return (failedGames == 0) ? 0 : 1;
+}
+
+int query(const std::string &indexPath, const std::string &fen, const std::string &archivePath) {
+    PositionIndexReader index(indexPath);
+    std::unique_ptr<GameArchiveReader> archive;
+    if (!archivePath.empty()) {
+        archive = std::make_unique<GameArchiveReader>(archivePath);
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto matches = index.findFen(fen);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    for (const auto &match: matches) {
+        std::cout << "Game " << match.gameIndex + 1 << ", ply " << match.ply;
+        if (archive != nullptr && match.gameIndex < archive->getGameCount()) {
+            auto game = archive->getGame(match.gameIndex);
+            for (const auto &tag: game.tags) {
+                if (tag.first == "White" || tag.first == "Black") {
+                    std::cout << ((tag.first == "White") ? " (" : " - ") << tag.second
+                              << ((tag.first == "White") ? "" : ")");
+                }
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << matches.size() << " matches in " << elapsed << " ms" << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    try {
+        if (command == "build" && (argc == 4 || argc == 5)) {
+            return build(argv[2], argv[3], threadCountArgument(argc, argv, 4));
+        } else if (command == "query" && (argc == 4 || argc == 5)) {
+            return query(argv[2], argv[3], (argc == 5) ? argv[4] : "");
+        }
+    } catch (const ChessException &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    printUsage(argv[0]);
+    return 2;
+}
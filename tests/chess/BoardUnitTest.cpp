@@ -79,5 +79,59 @@ namespace BoardUnitTest {
         ASSERT_TRUE(board->getField(pos("f3"))->isEmpty());
         ASSERT_FALSE(board->getField(pos("e5"))->isEmpty());
     }
-}
 
+    TEST(Board, piecesBeyondTheInitialArenaBlock) {
+        auto board = Board::startingBoard();
+        std::vector<Piece *> restored;
+        for (int i = 0; i < 40; i++) {
+            restored.push_back(board->restorePiece(PieceType::QUEEN, Color::WHITE));
+            restored.back()->setField(board->getField(Position(4, 1)));
+        }
+        ASSERT_EQ(board->getAllPieces().size(), 72);
+        for (auto piece: restored) {
+            ASSERT_EQ(piece->getType(), PieceType::QUEEN);
+            ASSERT_EQ(piece->getColor(), Color::WHITE);
+        }
+        ASSERT_EQ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", fen(board));
+        delete board;
+    }
+
+    TEST(Board, promotionsReuseArenaSlots) {
+        auto board = fenBoard("4k3/P7/8/8/8/8/8/4K3");
+        auto pawn = board->getField(pos("a7"))->getPiece();
+        auto move = Move(pos("a7"), pos("a8"), pawn, nullptr, PieceType::KNIGHT);
+
+        board->makeMove(move);
+        auto knight = board->getField(pos("a8"))->getPiece();
+        board->reverseMove(move);
+        for (int i = 0; i < 100; i++) {
+            board->makeMove(move);
+            ASSERT_EQ(board->getField(pos("a8"))->getPiece(), knight);
+            board->reverseMove(move);
+        }
+        ASSERT_EQ(board->getAllPieces().size(), 3);
+        ASSERT_EQ("4k3/P7/8/8/8/8/8/4K3", fen(board));
+        delete board;
+    }
+
+    TEST(Board, copyKeepsTheCounters) {
+        auto board = fenBoard("r3k2r/1P6/8/3pP3/8/2B5/8/R3K1BR");
+        Board copy(*board);
+        ASSERT_EQ(fen(copy), fen(board));
+        ASSERT_EQ(copy.getSquares(), board->getSquares());
+        ASSERT_EQ(copy.getOccupied(), board->getOccupied());
+        ASSERT_EQ(copy.getPieceCount(Color::WHITE, PieceType::BISHOP), 2);
+        ASSERT_EQ(copy.getPieceCount(Color::BLACK, PieceType::ROOK), 2);
+        for (auto piece: copy.getAllPieces()) {
+            ASSERT_EQ(piece->getField()->getPiece(), piece);
+            ASSERT_EQ(piece->getBoard(), &copy);
+        }
+
+        auto pawn = copy.getField(pos("b7"))->getPiece();
+        copy.makeMove(Move(pos("b7"), pos("a8"), pawn, copy.getField(pos("a8"))->getPiece(), PieceType::QUEEN));
+        ASSERT_EQ(copy.getPieceCount(Color::WHITE, PieceType::QUEEN), 1);
+        ASSERT_EQ(copy.getPieceCount(Color::BLACK, PieceType::ROOK), 1);
+        ASSERT_EQ(board->getPieceCount(Color::BLACK, PieceType::ROOK), 2);
+        delete board;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include "gtest/gtest.h"
+#include "EpdReader.h"
+#include "FENParser.h"
+#include "ChessExceptions.h"
+
+namespace EpdReaderUnitTest {
+    const std::string suite =
+            "# tactical and perft positions\n"
+            "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id \"WAC.001\";\n"
+            "\n"
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1 ;D1 48 ;D2 2039\r\n"
+            "4k3/8/8/8/8/8/8/4K3 b - - hmvc 12; fmvn 40; c0 \"a; b\"; id \"clocks\";\n"
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 bm e4;\n";
+
+    TEST(EpdReader, operationsAreViewsIntoTheLine) {
+        auto record = EpdRecord::parse("2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - "
+                                       "bm Qg6 Qh5; ce +320; id \"WAC.001\";");
+        ASSERT_FALSE(record.error);
+        ASSERT_EQ(record.position.state.sideToMove, Color::WHITE);
+        ASSERT_EQ(record.position.state.fullmoveNumber, 1);
+        ASSERT_EQ(record.getOperation("bm"), "Qg6 Qh5");
+        ASSERT_EQ(record.getOperation("ce"), "+320");
+        ASSERT_EQ(record.getOperation("id"), "WAC.001");
+        ASSERT_FALSE(record.getOperation("am").has_value());
+        ASSERT_GE(record.getOperation("id")->data(), record.line.data());
+        ASSERT_LE(record.getOperation("id")->data(), record.line.data() + record.line.size());
+
+        std::vector<std::string> opcodes;
+        record.forEachOperation([&opcodes](std::string_view opcode, std::string_view) {
+            opcodes.emplace_back(opcode);
+        });
+        ASSERT_EQ(opcodes, (std::vector<std::string>{"bm", "ce", "id"}));
+    }
+
+    TEST(EpdReader, recordsOfAFile) {
+        std::vector<EpdRecord> records;
+        EpdReader::forEachRecord(suite, [&records](const EpdRecord &record) {
+            records.push_back(record);
+        });
+        ASSERT_EQ(records.size(), 4);
+
+        ASSERT_EQ(records[1].getOperation("D2"), "2039");
+        ASSERT_EQ(records[1].line.back(), '9');
+
+        ASSERT_FALSE(records[2].error);
+        ASSERT_EQ(records[2].position.state.halfmoveClock, 12);
+        ASSERT_EQ(records[2].position.state.fullmoveNumber, 40);
+        ASSERT_EQ(records[2].getOperation("c0"), "a; b");
+        ASSERT_EQ(records[2].getOperation("id"), "clocks");
+
+        // e4 is not an en passant target field
+        ASSERT_TRUE(records[3].error);
+        ASSERT_EQ(records[3].error.offset, 51);
+    }
+
+    TEST(EpdReader, chunksEndAtLineBoundaries) {
+        for (size_t count = 1; count <= 8; count++) {
+            auto chunks = EpdReader::splitChunks(suite, count);
+            ASSERT_LE(chunks.size(), count);
+            std::string joined;
+            for (const auto &chunk: chunks) {
+                ASSERT_FALSE(chunk.empty());
+                ASSERT_TRUE(chunk.back() == '\n' || chunk.data() + chunk.size() == suite.data() + suite.size());
+                joined += chunk;
+            }
+            ASSERT_EQ(joined, suite);
+        }
+    }
+
+    TEST(EpdReader, parallelReadOfMappedFile) {
+        auto path = testing::TempDir() + "EpdReaderUnitTest.epd";
+        {
+            std::ofstream file(path, std::ios::binary);
+            for (int i = 0; i < 100; i++) {
+                file << suite;
+            }
+        }
+
+        EpdReader reader(path);
+        std::mutex mutex;
+        size_t records = 0;
+        size_t invalid = 0;
+        auto chunks = reader.forEachRecordParallel(4, [&](const EpdRecord &record, size_t chunk) {
+            ASSERT_LT(chunk, 4);
+            std::lock_guard<std::mutex> lock(mutex);
+            records++;
+            invalid += record.error ? 1 : 0;
+        });
+        ASSERT_EQ(chunks, 4);
+        ASSERT_EQ(records, 400);
+        ASSERT_EQ(invalid, 100);
+        std::remove(path.c_str());
+
+        ASSERT_THROW(EpdReader missing(path), EpdException);
+    }
+}
@@ -176,4 +176,89 @@ namespace FENParserUnitTest {
         ASSERT_EQ(whiteKingMoves.size(), 2);
         ASSERT_EQ(blackKingMoves.size(), 2);
     }
-}
\ No newline at end of file
+
+    TEST(FENParser, positionWithoutGame) {
+        CompactPosition position{};
+        auto error = FENParser::parsePosition("r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 3 41", position);
+        ASSERT_FALSE(error);
+        ASSERT_EQ(position.squares[pos("a8").getIndex()], makePieceCode(Color::BLACK, PieceType::ROOK));
+        ASSERT_EQ(position.squares[pos("e5").getIndex()], makePieceCode(Color::WHITE, PieceType::PAWN));
+        ASSERT_EQ(position.squares[pos("e4").getIndex()], NO_PIECE);
+        ASSERT_EQ(position.state.sideToMove, Color::WHITE);
+        ASSERT_EQ(position.state.castlingRights, GameState::WHITE_KINGSIDE | GameState::BLACK_QUEENSIDE);
+        ASSERT_EQ(position.state.getEnPassantSquare(), pos("d6").toSquare());
+        ASSERT_EQ(position.state.halfmoveClock, 3);
+        ASSERT_EQ(position.state.fullmoveNumber, 41);
+    }
+
+    TEST(FENParser, errorOffsets) {
+        CompactPosition position{};
+        auto offsetOf = [&position](const std::string &fen) {
+            auto error = FENParser::parsePosition(fen, position);
+            return error ? static_cast<int>(error.offset) : -1;
+        };
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), -1);
+        ASSERT_EQ(offsetOf("rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 13);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 18);
+        ASSERT_EQ(offsetOf("rnbqkbnr/ppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 16);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1"), 44);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkk - 0 1"), 49);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1"), 51);
+        ASSERT_EQ(offsetOf("rnbqkbnP/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 7);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNp w KQkq - 0 1"), 42);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/8/8/8/R3K3 w KQ - 0 1"), 23);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/8/8/8/3K3R w K - 0 1"), 23);
+        ASSERT_EQ(offsetOf("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"), -1);
+        ASSERT_EQ(offsetOf("r3k2r/8/8/8/8/8/8/R3K2R w KQkr - 0 1"), 29);
+        ASSERT_EQ(offsetOf("r3k3/8/8/8/8/8/8/R3K2R w KQkq - 0 1"), 27);
+        // en passant target on the wrong rank for the side to move, without the pawn or with an occupied field
+        ASSERT_EQ(offsetOf("4k3/8/8/8/4P3/8/8/4K3 w - e3 0 1"), 26);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/4P3/8/8/4K3 b - e3 0 1"), -1);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/8/8/8/4K3 w - e3 0 1"), 24);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/8/8/8/4K3 b - e3 0 1"), 24);
+        ASSERT_EQ(offsetOf("4k3/8/8/8/4p3/8/8/4K3 b - e3 0 1"), 26);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e6 0 1"), 51);
+        ASSERT_EQ(offsetOf("4k3/8/4n3/4p3/8/8/8/4K3 w - e6 0 1"), 28);
+        ASSERT_EQ(offsetOf("4k3/4n3/8/4p3/8/8/8/4K3 w - e6 0 1"), 28);
+        ASSERT_EQ(offsetOf("4k3/8/8/4p3/8/8/8/4K3 w - e6 0 1"), -1);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e9 0 1"), 51);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 70000 1"), 53);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0"), 54);
+        ASSERT_EQ(offsetOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 "), 56);
+
+        try {
+            FENParser::parseGame("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1x");
+            FAIL();
+        } catch (FenException &e) {
+            ASSERT_EQ(e.getOffset(), 56);
+        }
+        ASSERT_THROW(FENParser::parseGame("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQQBNR w KQkq - 0 1"), FenException);
+    }
+
+    TEST(FENParser, writeIntoBuffer) {
+        for (const auto &fen: {"r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 3 41",
+                               "4k3/8/8/8/8/8/8/4K3 b - - 0 1",
+                               "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"}) {
+            CompactPosition position{};
+            ASSERT_FALSE(FENParser::parsePosition(fen, position));
+            FENParser::FenBuffer buffer;
+            auto length = FENParser::writePosition(position, buffer);
+            ASSERT_EQ(std::string(buffer), fen);
+            ASSERT_EQ(length, std::string(fen).size());
+        }
+
+        // the longest possible string fills the whole buffer
+        std::string longest = "rnbqkbnr/1ppppppp/1ppppppp/pppppppp/PPPPPPPP/PPPPPPPP/PPPPPPPP/RNBQKBNR w KQkq a6 65535 65535";
+        ASSERT_EQ(longest.size(), FENParser::MAX_FEN_LENGTH);
+        CompactPosition position{};
+        ASSERT_FALSE(FENParser::parsePosition(longest, position));
+        FENParser::FenBuffer buffer;
+        ASSERT_EQ(FENParser::writePosition(position, buffer), FENParser::MAX_FEN_LENGTH);
+        ASSERT_EQ(std::string(buffer), longest);
+
+        auto game = fenGame("r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 3 41");
+        std::string output = "position fen ";
+        FENParser::appendGame(game, output);
+        ASSERT_EQ(output, "position fen r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 3 41");
+    }
+}
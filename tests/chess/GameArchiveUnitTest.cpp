@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "GameArchive.h"
+#include "PGNParser.h"
+#include "Game.h"
+#include "Move.h"
+#include "ChessExceptions.h"
+#include "pieces/PieceType.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace GameArchiveUnitTest {
+    const std::string operaGame =
+            "[Event \"Paris\"]\n"
+            "[White \"Morphy\"]\n"
+            "[Black \"Duke Karl / Count Isouard\"]\n"
+            "[Result \"1-0\"]\n"
+            "\n"
+            "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7 8. Nc3 c6\n"
+            "9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7 14. Rd1 Qe6\n"
+            "15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n";
+
+    const std::string promotionGame =
+            "[FEN \"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1\"]\n"
+            "\n"
+            "1. b8=N Kf7 2. Kd2 *\n";
+
+    TEST(GameArchive, canonicalLegalMovesOrder) {
+        auto game = fenGame("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+        auto moves = GameArchive::canonicalLegalMoves(game);
+
+        // 5 king moves and 4 promotions, sorted by source field
+        ASSERT_EQ(9, moves.size());
+        ASSERT_EQ(pos("e1"), moves[0].getFrom());
+        ASSERT_EQ(pos("b7"), moves[5].getFrom());
+        ASSERT_EQ(PieceType::ROOK, moves[5].getPromoteTo());
+        ASSERT_EQ(PieceType::BISHOP, moves[6].getPromoteTo());
+        ASSERT_EQ(PieceType::KNIGHT, moves[7].getPromoteTo());
+        ASSERT_EQ(PieceType::QUEEN, moves[8].getPromoteTo());
+    }
+
+    TEST(GameArchive, encodeDecodeMove) {
+        auto game = Game();
+        for (size_t i = 0; i < 20; i++) {
+            auto move = GameArchive::decodeMove(game, i);
+            ASSERT_EQ(i, GameArchive::encodeMove(game, move));
+        }
+        ASSERT_THROW(GameArchive::decodeMove(game, 20), ArchiveException);
+    }
+
+    TEST(GameArchive, decodeMoveFollowsCanonicalOrder) {
+        // promotions with and without a capture, castlings and an en passant capture
+        for (auto fen: {"r1n1k2r/1P6/8/3pP3/8/8/6p1/R3K2R w KQkq d6 0 1",
+                        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1"}) {
+            auto game = fenGame(fen);
+            auto moves = GameArchive::canonicalLegalMoves(game);
+            for (size_t i = 0; i < moves.size(); i++) {
+                auto move = GameArchive::decodeMove(game, i);
+                ASSERT_EQ(moves[i], move);
+                ASSERT_EQ(moves[i].getPromoteTo(), move.getPromoteTo());
+                ASSERT_EQ(i, GameArchive::encodeMove(game, moves[i]));
+            }
+            ASSERT_THROW(GameArchive::decodeMove(game, moves.size()), ArchiveException);
+        }
+    }
+
+    TEST(GameArchive, pgnRoundTrip) {
+        auto pgnGame = PGNParser::parseGame(operaGame);
+        auto archivedGame = GameArchive::fromPgn(pgnGame);
+
+        ASSERT_EQ(33, archivedGame.moves.size());
+        ASSERT_EQ("1-0", archivedGame.result);
+        auto decoded = GameArchive::toPgn(archivedGame);
+        ASSERT_EQ(pgnGame.tags, decoded.tags);
+        ASSERT_EQ(pgnGame.moves, decoded.moves);
+        ASSERT_EQ(pgnGame.result, decoded.result);
+    }
+
+    TEST(GameArchive, replay) {
+        auto archivedGame = GameArchive::fromPgn(PGNParser::parseGame(promotionGame));
+        std::vector<std::string> positions;
+        GameArchive::replay(archivedGame, [&positions](const Game &game, size_t ply) {
+            ASSERT_EQ(positions.size(), ply);
+            positions.push_back(fen(game));
+        });
+
+        ASSERT_EQ(4, positions.size());
+        ASSERT_EQ("1N2k3/8/8/8/8/8/8/4K3 b - - 0 1", positions[1]);
+        ASSERT_EQ("1N6/5k2/8/8/8/8/3K4/8 b - - 2 2", positions[3]);
+    }
+
+    TEST(GameArchive, fileRandomAccess) {
+        auto path = testing::TempDir() + "GameArchiveUnitTest.cga";
+        auto opera = GameArchive::fromPgn(PGNParser::parseGame(operaGame));
+        auto promotion = GameArchive::fromPgn(PGNParser::parseGame(promotionGame));
+        {
+            GameArchiveWriter writer(path);
+            writer.addGame(opera);
+            writer.addGame(promotion);
+            writer.addGame(opera);
+        }
+
+        GameArchiveReader reader(path);
+        ASSERT_EQ(3, reader.getGameCount());
+        ASSERT_EQ(promotion.moves, reader.getGame(1).moves);
+        ASSERT_EQ(promotion.tags, reader.getGame(1).tags);
+        ASSERT_EQ("*", reader.getGame(1).result);
+        ASSERT_EQ(opera.moves, reader.getGame(2).moves);
+        ASSERT_THROW(reader.getGame(3), ArchiveException);
+        std::remove(path.c_str());
+    }
+
+    TEST(GameArchive, invalidFile) {
+        auto path = testing::TempDir() + "GameArchiveUnitTestInvalid.cga";
+        {
+            std::ofstream file(path);
+            file << "[Event \"not an archive\"]\n";
+        }
+
+        ASSERT_THROW(GameArchiveReader reader(path), ArchiveException);
+        ASSERT_THROW(GameArchiveReader reader(path + ".missing"), ArchiveException);
+        std::remove(path.c_str());
+    }
+}
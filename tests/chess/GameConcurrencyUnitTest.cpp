@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <thread>
+#include "gtest/gtest.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "Color.h"
+#include "GameOver.h"
+#include "FENParser.h"
+#include "PGNParser.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+/**
+ * Many threads querying one game, meant to be run with ThreadSanitizer (-DCHESS_SANITIZE_THREAD=ON)
+ */
+namespace GameConcurrencyUnitTest {
+    constexpr int THREADS = 8;
+    constexpr int ITERATIONS = 50;
+
+    struct Answers {
+        std::string fen;
+        std::vector<std::string> sanMoves;
+        std::vector<std::string> movesFromKnight;
+        bool whiteInCheck;
+        bool blackInCheck;
+        GameOver result;
+        size_t legalMoveCount;
+    };
+
+    Answers query(const Game &game) {
+        Answers answers;
+        answers.fen = FENParser::gameToString(game);
+        for (const auto &move: game.getLegalMovesForPlayer(game.getCurrentPlayer())) {
+            answers.sanMoves.push_back(PGNParser::moveToSan(move, game));
+        }
+        for (const auto &move: game.getLegalMovesFrom(pos("e5"))) {
+            answers.movesFromKnight.push_back(move.toSmithNotation());
+        }
+        answers.whiteInCheck = game.isCheck(Color::WHITE);
+        answers.blackInCheck = game.isCheck(Color::BLACK);
+        answers.result = game.isOver();
+        answers.legalMoveCount = game.getLegalMoveCount();
+        return answers;
+    }
+
+    void expectEqual(const Answers &actual, const Answers &expected) {
+        EXPECT_EQ(actual.fen, expected.fen);
+        EXPECT_EQ(actual.sanMoves, expected.sanMoves);
+        EXPECT_EQ(actual.movesFromKnight, expected.movesFromKnight);
+        EXPECT_EQ(actual.whiteInCheck, expected.whiteInCheck);
+        EXPECT_EQ(actual.blackInCheck, expected.blackInCheck);
+        EXPECT_EQ(actual.result, expected.result);
+        EXPECT_EQ(actual.legalMoveCount, expected.legalMoveCount);
+    }
+
+    TEST(GameConcurrency, concurrentConstQueries) {
+        auto game = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        // the answers of a copy, so that the shared game's status is computed by the threads
+        auto expected = query(Game(game));
+        ASSERT_EQ(expected.sanMoves.size(), 48);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREADS; i++) {
+            threads.emplace_back([&game, &expected]() {
+                for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+                    expectEqual(query(game), expected);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+    TEST(GameConcurrency, copiesPlayedWhileTheGameIsQueried) {
+        auto game = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        auto expected = query(Game(game));
+        auto expectedPerft = Game(game).perft(2);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREADS; i++) {
+            threads.emplace_back([&game, &expected, expectedPerft, i]() {
+                for (int iteration = 0; iteration < ITERATIONS / 10; iteration++) {
+                    if (i % 2 == 0) {
+                        auto copy = game;
+                        EXPECT_EQ(copy.perft(2), expectedPerft);
+                        auto moves = copy.getLegalMovesForPlayer(copy.getCurrentPlayer());
+                        copy.makeMove(moves[i]);
+                        copy.undoMove();
+                        expectEqual(query(copy), expected);
+                    } else {
+                        expectEqual(query(game), expected);
+                    }
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+}
@@ -17,6 +17,7 @@
 #include "GameOver.h"
 #include "pieces/PieceType.h"
 #include "FENParser.h"
+#include "PGNParser.h"
 
 using namespace ChessUnitTestCommon;
 
@@ -461,7 +462,7 @@ namespace GameUnitTest {
     }
 
     TEST(Game, availableMovesUnderCheck) {
-        auto game = fenGame("k7/8/8/8/8/6b1/3PP3/3PKP2 w - - 0 1");
+        auto game = fenGame("k7/8/8/8/8/6b1/3PP3/3RKR2 w - - 0 1");
         auto onlyMove = Move(pos("f1"), pos("f2"), game.getPiece(pos("f1")), nullptr);
         auto movesForWhite = game.getLegalMovesForPlayer(game.getWhitePlayer());
 
@@ -669,12 +670,38 @@ namespace GameUnitTest {
         ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
     }
 
+    TEST(Game, insufficientMaterialSameColoredBishops) {
+        auto game = fenGame("k4b2/8/8/8/8/8/1B6/K1B5 w - - 0 1");
+        ASSERT_EQ(game.isOver(), GameOver::INSUFFICIENT_MATERIAL);
+    }
+
+    TEST(Game, sufficientMaterialOppositeColoredBishops) {
+        auto game = fenGame("k1b5/8/8/8/8/8/8/KBB5 w - - 0 1");
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+    }
+
+    TEST(Game, insufficientMaterialAfterCaptureAndPromotion) {
+        auto game = fenGame("k7/6P1/8/8/8/8/8/K5r1 w - - 0 1");
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+        game.makeMove(Move::parseSmithNotation("g7g8n", game));
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+        game.makeMove(Move::parseSmithNotation("g1g8", game));
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+        ASSERT_EQ(1, game.getBoard()->getPieceCount(Color::BLACK, PieceType::ROOK));
+        ASSERT_EQ(0, game.getBoard()->getPieceCount(Color::WHITE, PieceType::KNIGHT));
+        game.undoMove();
+        ASSERT_EQ(1, game.getBoard()->getPieceCount(Color::WHITE, PieceType::KNIGHT));
+        game.undoMove();
+        ASSERT_EQ(1, game.getBoard()->getPieceCount(Color::WHITE, PieceType::PAWN));
+        ASSERT_EQ(0, game.getBoard()->getPieceCount(Color::WHITE, PieceType::KNIGHT));
+    }
+
     TEST(Game, sufficientMaterialRook) {
         auto game = fenGame("k7/8/8/8/8/8/K1R5/8 w - - 0 1");
         ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
     }
 
-    TEST(Game, positionCountMechanics) {
+    TEST(Game, repetitionCountMechanics) {
         auto game = Game();
         auto e4 = Move(pos("e2"), pos("e4"), game.getPiece(pos("e2")));
         auto d5 = Move(pos("d7"), pos("d5"), game.getPiece(pos("d7")));
@@ -683,25 +710,33 @@ namespace GameUnitTest {
 
         game.makeMove(e4);
         game.makeMove(d5);
+        auto hashAfterD5 = game.getHash();
         game.makeMove(nf3);
         game.makeMove(nc6);
-        auto expectedPositionCount = std::map<std::string, int>{
-                {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR",         1},
-                {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR",       1},
-                {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR",     1},
-                {"rnbqkbnr/ppp1pppp/8/3p4/4P3/5N2/PPPP1PPP/RNBQKB1R",   1},
-                {"r1bqkbnr/ppp1pppp/2n5/3p4/4P3/5N2/PPPP1PPP/RNBQKB1R", 1},
-        };
-        ASSERT_EQ(game.getPositionCount(), expectedPositionCount);
+        ASSERT_EQ(game.getRepetitionCount(), 0);
         auto ng1 = Move(pos("f3"), pos("g1"), game.getPiece(pos("f3")));
         auto game2 = game.afterMove(ng1);
-        ASSERT_EQ(game.getPositionCount(), expectedPositionCount);
+        ASSERT_EQ(game.getRepetitionCount(), 0);
         auto game2nb8 = Move(pos("c6"), pos("b8"), game2.getPiece(pos("c6")));
         game2.makeMove(game2nb8);
-        ASSERT_EQ(game.getPositionCount(), expectedPositionCount);
-        expectedPositionCount["r1bqkbnr/ppp1pppp/2n5/3p4/4P3/8/PPPP1PPP/RNBQKBNR"] += 1;
-        expectedPositionCount["rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR"] += 1;
-        ASSERT_EQ(game2.getPositionCount(), expectedPositionCount);
+        ASSERT_EQ(game2.getHash(), hashAfterD5);
+        ASSERT_EQ(game2.getRepetitionCount(), 1);
+        ASSERT_EQ(game.getRepetitionCount(), 0);
+
+        game2.undoMove();
+        ASSERT_EQ(game2.getRepetitionCount(), 0);
+        game2.redoMove();
+        ASSERT_EQ(game2.getRepetitionCount(), 1);
+    }
+
+    TEST(Game, repetitionOnlySinceIrreversibleMove) {
+        // the same board with different castling rights is a different position
+        auto game = fenGame("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+        for (const auto &move: {"e1f1", "e8f8", "f1e1", "f8e8", "e1f1", "e8f8", "f1e1", "f8e8"}) {
+            game.makeMove(Move::parseSmithNotation(move, game));
+        }
+        ASSERT_EQ(game.getRepetitionCount(), 1);
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
     }
 
     TEST(Game, threefoldRepetitionSandomierzGambit) {
@@ -751,7 +786,7 @@ namespace GameUnitTest {
         ASSERT_TRUE(game.getCanWhiteQueensideCastle());
         ASSERT_TRUE(game.getCurrentPlayer()->getColor() == Color::WHITE);
         ASSERT_EQ(game.getEnPassantTargetPiece(), nullptr);
-        ASSERT_EQ(game.getEnPassantTargetPosition(), nullptr);
+        ASSERT_FALSE(game.getEnPassantTargetPosition().has_value());
         ASSERT_EQ(game.getHalfmoveClock(), 0);
         ASSERT_EQ(game.getFullmoveNumber(), 1);
         ASSERT_EQ(game.getMovesIntoThePast(), 1);
@@ -783,7 +818,7 @@ namespace GameUnitTest {
         ASSERT_TRUE(game.getCanWhiteQueensideCastle());
         ASSERT_TRUE(game.getCurrentPlayer()->getColor() == Color::WHITE);
         ASSERT_EQ(game.getEnPassantTargetPiece(), nullptr);
-        ASSERT_EQ(game.getEnPassantTargetPosition(), nullptr);
+        ASSERT_FALSE(game.getEnPassantTargetPosition().has_value());
         ASSERT_EQ(game.getHalfmoveClock(), 4);
         ASSERT_EQ(game.getFullmoveNumber(), 4);
         ASSERT_EQ(game.getMovesIntoThePast(), 1);
@@ -824,7 +859,7 @@ namespace GameUnitTest {
         ASSERT_TRUE(game.getCanBlackQueensideCastle());
         ASSERT_TRUE(game.getCanWhiteQueensideCastle());
         ASSERT_EQ(game.getEnPassantTargetPiece(), nullptr);
-        ASSERT_EQ(game.getEnPassantTargetPosition(), nullptr);
+        ASSERT_FALSE(game.getEnPassantTargetPosition().has_value());
         ASSERT_EQ(game.getHalfmoveClock(), 0);
         ASSERT_EQ(game.getFullmoveNumber(), 1);
         ASSERT_EQ(game.getMovesIntoThePast(), 1);
@@ -849,4 +884,130 @@ namespace GameUnitTest {
         ASSERT_EQ(game.getFullmoveNumber(), 3);
         ASSERT_EQ(game.getMovesIntoThePast(), 1);
     }
-}
\ No newline at end of file
+
+    TEST(Game, undoRestoresPreviousEnPassantTarget) {
+        auto game = Game();
+        game.makeMove(Move(pos("e2"), pos("e4"), game.getPiece(pos("e2"))));
+        game.makeMove(Move(pos("d7"), pos("d5"), game.getPiece(pos("d7"))));
+        game.undoMove();
+
+        ASSERT_EQ("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", fen(game));
+        ASSERT_EQ(game.getEnPassantTargetPiece(), game.getPiece(pos("e4")));
+    }
+
+    TEST(Game, undoRestoresTheCapturedPiece) {
+        auto game = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        auto h3Pawn = game.getPiece(pos("h3"));
+        auto g2Pawn = game.getPiece(pos("g2"));
+        auto e6Pawn = game.getPiece(pos("e6"));
+        for (auto move: {"d5e6", "h3g2", "f3g2"}) {
+            game.makeMove(Move::parseSmithNotation(move, game));
+        }
+        game.undoMove();
+        ASSERT_EQ(game.getPiece(pos("g2")), h3Pawn);
+        game.undoMove();
+        ASSERT_EQ(game.getPiece(pos("h3")), h3Pawn);
+        ASSERT_EQ(game.getPiece(pos("g2")), g2Pawn);
+        game.undoMove();
+        ASSERT_EQ(game.getPiece(pos("e6")), e6Pawn);
+    }
+
+    TEST(Game, undoAndRedoWholeGame) {
+        auto game = Game();
+        std::vector<std::string> positions = {fen(game)};
+        for (const auto &san: {"e4", "d5", "exd5", "Qxd5", "Nc3", "Qa5", "d4", "c6", "Nf3", "Bg4", "Bf4", "e6",
+                               "h3", "Bxf3", "Qxf3", "Bb4", "Be2", "Nd7", "a3", "O-O-O", "axb4", "Qxa1+"}) {
+            game.makeMove(PGNParser::parseSan(san, game));
+            positions.push_back(fen(game));
+        }
+
+        for (auto i = positions.size() - 1; i > 0; i--) {
+            game.undoMove();
+            ASSERT_EQ(positions[i - 1], fen(game));
+        }
+        for (size_t i = 1; i < positions.size(); i++) {
+            game.redoMove();
+            ASSERT_EQ(positions[i], fen(game));
+        }
+        ASSERT_EQ(13, game.getWhitePlayer()->getPieces().size());
+        ASSERT_EQ(13, game.getBlackPlayer()->getPieces().size());
+    }
+
+    TEST(Game, terminalStatusRecomputedAfterMoveAndUndo) {
+        auto game = Game();
+        ASSERT_EQ(20, game.getLegalMoveCount());
+        ASSERT_FALSE(game.isCurrentPlayerInCheck());
+
+        for (const auto &move: {"f2f3", "e7e5", "g2g4"}) {
+            game.makeMove(Move::parseSmithNotation(move, game));
+        }
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+        game.makeMove(Move::parseSmithNotation("d8h4", game));
+        ASSERT_EQ(game.isOver(), GameOver::MATE);
+        ASSERT_TRUE(game.isCurrentPlayerInCheck());
+        ASSERT_EQ(0, game.getLegalMoveCount());
+
+        game.undoMove();
+        ASSERT_EQ(game.isOver(), GameOver::NOT_OVER);
+        ASSERT_FALSE(game.isMate());
+        ASSERT_FALSE(game.isCurrentPlayerInCheck());
+    }
+
+    TEST(Game, copyIsIndependent) {
+        auto game = fenGame("rnbqkbnr/ppp1ppp1/7p/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+        game.makeMove(Move(pos("g1"), pos("f3"), game.getPiece(pos("g1"))));
+        game.undoMove();
+        auto copy = game;
+
+        ASSERT_EQ(fen(copy), fen(game));
+        ASSERT_EQ(copy.getHash(), game.getHash());
+        ASSERT_NE(copy.getBoard(), game.getBoard());
+        ASSERT_EQ(copy.getEnPassantTargetPiece(), copy.getPiece(pos("d5")));
+        ASSERT_EQ(copy.getWhitePlayer()->getPieces().size(), 16);
+        auto legalMoves = copy.getLegalMovesForPlayer(copy.getCurrentPlayer());
+        ASSERT_EQ(legalMoves.size(), game.getLegalMovesForPlayer(game.getCurrentPlayer()).size());
+        for (const auto &move: legalMoves) {
+            ASSERT_EQ(move.getPiece()->getBoard(), copy.getBoard());
+        }
+
+        copy.makeMove(Move(pos("e5"), pos("d6"), copy.getPiece(pos("e5")), copy.getPiece(pos("d5"))));
+        ASSERT_EQ("rnbqkbnr/ppp1ppp1/3P3p/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3", fen(copy));
+        ASSERT_EQ("rnbqkbnr/ppp1ppp1/7p/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3", fen(game));
+        copy.undoMove();
+        ASSERT_EQ(fen(copy), fen(game));
+        copy.redoMove();
+        ASSERT_EQ("rnbqkbnr/ppp1ppp1/3P3p/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3", fen(copy));
+
+        // the undone move of the original is kept
+        game.redoMove();
+        ASSERT_EQ("rnbqkbnr/ppp1ppp1/7p/3pP3/8/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 3", fen(game));
+        copy = game;
+        ASSERT_EQ(fen(copy), fen(game));
+        ASSERT_EQ(copy.getMovesIntoThePast(), 0);
+    }
+
+    TEST(Game, enPassantTargetWithoutPawn) {
+        CompactPosition position{};
+        ASSERT_FALSE(FENParser::parsePosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1", position));
+        position.state.enPassantSquare = static_cast<int8_t>(pos("e6").getIndex());
+        Game game(position);
+        ASSERT_EQ(game.getEnPassantTargetPiece(), nullptr);
+
+        auto copy = game;
+        copy.makeMove(Move(pos("e1"), pos("d1"), copy.getPiece(pos("e1"))));
+        ASSERT_EQ("4k3/8/8/8/8/8/8/3K4 b - - 1 1", fen(copy));
+    }
+
+    TEST(Game, moveTakesOverTheBoard) {
+        auto game = fenGame("8/8/8/8/8/8/8/k1K5 w - - 0 1");
+        auto board = game.getBoard();
+        auto moved = std::move(game);
+        ASSERT_EQ(moved.getBoard(), board);
+        ASSERT_EQ("8/8/8/8/8/8/8/k1K5 w - - 0 1", fen(moved));
+
+        game = Game();
+        ASSERT_EQ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", fen(game));
+        moved = std::move(game);
+        ASSERT_EQ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", fen(moved));
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <thread>
+#include "gtest/gtest.h"
+#include "MoveCache.h"
+#include "Game.h"
+#include "Move.h"
+#include "Player.h"
+#include "FENParser.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace MoveCacheUnitTest {
+    std::vector<std::string> notations(const std::vector<Move> &moves) {
+        std::vector<std::string> result;
+        for (const auto &move: moves) {
+            result.push_back(move.toSmithNotation() + (move.isCapture() ? "x" : ""));
+        }
+        return result;
+    }
+
+    std::vector<std::string> generatedMoves(const Game &game) {
+        Game uncached(game);
+        uncached.setMoveCache(nullptr);
+        return notations(uncached.getLegalMovesForPlayer(uncached.getCurrentPlayer()));
+    }
+
+    /**
+     * The positions after each of the moves from the starting one
+     */
+    std::vector<Game> positionsAfterFirstMove() {
+        Game start;
+        std::vector<Game> games;
+        for (const auto &move: start.getLegalMovesForPlayer(start.getCurrentPlayer())) {
+            Game game;
+            game.makeMove(Move::parseSmithNotation(move.toSmithNotation(), game));
+            games.push_back(game);
+        }
+        return games;
+    }
+
+    TEST(MoveCache, secondQueryIsAHit) {
+        MoveCache cache;
+        Game game;
+        game.setMoveCache(&cache);
+        auto first = game.getLegalMovesForPlayer(game.getCurrentPlayer());
+        ASSERT_EQ(cache.getMisses(), 1);
+        ASSERT_EQ(cache.getHits(), 0);
+
+        auto second = game.getLegalMovesForPlayer(game.getCurrentPlayer());
+        ASSERT_EQ(cache.getHits(), 1);
+        ASSERT_EQ(first, second);
+        ASSERT_EQ(notations(second), generatedMoves(game));
+        ASSERT_EQ(game.getLegalMovesFrom(pos("b1")).size(), 2);
+        ASSERT_EQ(game.getLegalMovesFrom(pos("g2")).size(), 2);
+        ASSERT_EQ(game.getLegalMovesFrom(pos("e7")).size(), 0);
+        ASSERT_EQ(cache.getHits(), 3);
+    }
+
+    TEST(MoveCache, listOfAnotherGameUsesItsPieces) {
+        MoveCache cache;
+        // en passant, both castlings and a promotion
+        auto fen = "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1";
+        auto first = FENParser::parseGame(fen);
+        auto second = FENParser::parseGame(fen);
+        first.setMoveCache(&cache);
+        second.setMoveCache(&cache);
+        first.getLegalMovesForPlayer(first.getCurrentPlayer());
+
+        auto moves = second.getLegalMovesForPlayer(second.getCurrentPlayer());
+        ASSERT_EQ(cache.getHits(), 1);
+        ASSERT_EQ(notations(moves), generatedMoves(second));
+        for (const auto &move: moves) {
+            ASSERT_EQ(move.getPiece(), second.getPiece(move.getFrom()));
+        }
+        auto enPassant = std::find_if(moves.begin(), moves.end(), [](const Move &move) {
+            return move.toSmithNotation() == "e5d6";
+        });
+        ASSERT_NE(enPassant, moves.end());
+        ASSERT_EQ(enPassant->getCapturedPiece(), second.getPiece(pos("d5")));
+
+        second.makeMove(*enPassant);
+        ASSERT_EQ(FENParser::gameToString(second), "r3k2r/1P6/3P4/8/8/8/8/R3K2R b KQkq - 0 1");
+    }
+
+    TEST(MoveCache, leastRecentlyUsedListIsReplaced) {
+        // a single set of 8 lists
+        MoveCache cache(MoveCache::WAYS);
+        ASSERT_EQ(cache.getCapacity(), MoveCache::WAYS);
+        auto games = positionsAfterFirstMove();
+        std::vector<Move> moves;
+        for (size_t i = 0; i < MoveCache::WAYS; i++) {
+            cache.getLegalMoves(games[i], moves);
+        }
+        cache.getLegalMoves(games[0], moves);
+        ASSERT_EQ(cache.getHits(), 1);
+
+        cache.getLegalMoves(games[MoveCache::WAYS], moves);
+        cache.getLegalMoves(games[0], moves);
+        ASSERT_EQ(cache.getHits(), 2);
+        cache.getLegalMoves(games[1], moves);
+        ASSERT_EQ(cache.getHits(), 2);
+        ASSERT_EQ(cache.getMisses(), MoveCache::WAYS + 2);
+        ASSERT_EQ(notations(moves), generatedMoves(games[1]));
+    }
+
+    TEST(MoveCache, gamesOnManyThreads) {
+        MoveCache cache(64);
+        auto games = positionsAfterFirstMove();
+        std::vector<std::vector<std::string>> expected;
+        for (const auto &game: games) {
+            expected.push_back(generatedMoves(game));
+        }
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 8; thread++) {
+            threads.emplace_back([&cache, &expected, thread]() {
+                auto games = positionsAfterFirstMove();
+                std::vector<Move> moves;
+                for (int i = 0; i < 200; i++) {
+                    auto index = (i * 7 + thread) % games.size();
+                    cache.getLegalMoves(games[index], moves);
+                    EXPECT_EQ(notations(moves), expected[index]);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        ASSERT_EQ(cache.getHits() + cache.getMisses(), 8 * 200);
+        ASSERT_GT(cache.getHits(), 0);
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "gtest/gtest.h"
+#include "MoveGenerator.h"
+#include "AttackTables.h"
+#include "SlidingAttacks.h"
+#include "Board.h"
+#include "Game.h"
+#include "FENParser.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace MoveGeneratorUnitTest {
+    TEST(MoveGenerator, squaresMirrorPiecesAfterMovesAndUndo) {
+        auto game = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        auto checkSquares = [&game]() {
+            for (int square = 0; square < 64; square++) {
+                auto piece = game.getBoard()->getPiece(Square(square));
+                auto expected = (piece == nullptr) ? NO_PIECE : makePieceCode(piece->getColor(), piece->getType());
+                ASSERT_EQ(game.getBoard()->getSquares()[square], expected);
+            }
+        };
+
+        for (const auto &move: game.getLegalMovesForPlayer(game.getCurrentPlayer())) {
+            game.makeMove(move);
+            checkSquares();
+            game.undoMove();
+            checkSquares();
+        }
+    }
+
+    TEST(MoveGenerator, isSquareAttacked) {
+        auto board = fenBoard("4k3/8/8/3p4/8/1N6/8/R3K3");
+        const auto &squares = board->getSquares();
+
+        ASSERT_TRUE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("e4").toSquare(), Color::BLACK));
+        ASSERT_TRUE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("c4").toSquare(), Color::BLACK));
+        ASSERT_FALSE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("d4").toSquare(), Color::BLACK));
+        ASSERT_TRUE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("a8").toSquare(), Color::WHITE));
+        ASSERT_TRUE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("d4").toSquare(), Color::WHITE));
+        ASSERT_FALSE(MoveGenerator::isSquareAttacked(squares, board->getOccupied(), pos("h8").toSquare(), Color::WHITE));
+        delete board;
+    }
+
+    TEST(MoveGenerator, pinnedPieceLeavesKingAttacked) {
+        auto game = fenGame("4k3/4r3/8/8/8/8/4B3/4K3 w - - 0 1");
+        auto bishopMoves = game.getLegalMovesFrom(pos("e2"));
+        ASSERT_TRUE(bishopMoves.empty());
+        ASSERT_EQ(game.getLegalMovesFrom(pos("e1")).size(), 4);
+    }
+
+    TEST(MoveGenerator, enPassantRemovingBothPawnsFromRankIsIllegal) {
+        auto game = fenGame("8/8/8/K2pP2r/8/8/8/7k w - d6 0 1");
+        auto pawnMoves = game.getLegalMovesFrom(pos("e5"));
+        ASSERT_EQ(pawnMoves.size(), 1);
+        ASSERT_EQ(pawnMoves[0].getTo(), pos("e6"));
+    }
+
+    TEST(MoveGenerator, enPassantOnlyForSideToMove) {
+        auto board = fenBoard("8/8/8/3pP3/8/8/8/8");
+        std::vector<Move> moves;
+        MoveGenerator::generatePieceMoves(*board, pos("e5").toSquare(), pos("d6").toSquare(), moves);
+        ASSERT_EQ(moves.size(), 2);
+
+        moves.clear();
+        MoveGenerator::generatePieceMoves(*board, pos("e5").toSquare(), Square(), moves);
+        ASSERT_EQ(moves.size(), 1);
+        delete board;
+    }
+
+    TEST(AttackTables, matchPiecesOnEmptyBoard) {
+        for (int index = 0; index < 64; index++) {
+            auto square = Square(index);
+            ASSERT_EQ(__builtin_popcountll(AttackTables::kingAttacks(square)),
+                      (square.getRank() % 7 == 0 ? 2 : 3) * (square.getFile() % 7 == 0 ? 2 : 3) - 1);
+            ASSERT_EQ(AttackTables::pawnAttacks(Color::WHITE, square) == 0, square.getRank() == 7);
+            ASSERT_EQ(AttackTables::pawnAttacks(Color::BLACK, square) == 0, square.getRank() == 0);
+        }
+
+        auto board = fenBoard("8/8/8/8/3N4/8/8/8");
+        std::vector<Move> moves;
+        MoveGenerator::generatePieceMoves(*board, pos("d4").toSquare(), Square(), moves);
+        Bitboard targets = 0;
+        for (const auto &move: moves) {
+            targets |= squareBit(move.getToSquare());
+        }
+        ASSERT_EQ(targets, AttackTables::knightAttacks(pos("d4").toSquare()));
+        ASSERT_EQ(moves.size(), 8);
+        delete board;
+    }
+
+    TEST(SlidingAttacks, stopOnFirstOccupiedField) {
+        auto board = fenBoard("8/3p4/8/8/1P1R2n1/8/8/8");
+        auto d4 = pos("d4").toSquare();
+        Bitboard expected = 0;
+        for (const auto &field: {"d5", "d6", "d7", "d3", "d2", "d1", "c4", "b4", "e4", "f4", "g4"}) {
+            expected |= squareBit(pos(field).toSquare());
+        }
+        ASSERT_EQ(SlidingAttacks::rookAttacks(d4, board->getOccupied()), expected);
+        ASSERT_EQ(__builtin_popcountll(SlidingAttacks::bishopAttacks(d4, board->getOccupied())), 13);
+        ASSERT_EQ(SlidingAttacks::queenAttacks(d4, board->getOccupied()),
+                  expected | SlidingAttacks::bishopAttacks(d4, board->getOccupied()));
+
+        std::vector<Move> moves;
+        MoveGenerator::generatePieceMoves(*board, d4, Square(), moves);
+        ASSERT_EQ(moves.size(), 10);
+        delete board;
+    }
+
+    TEST(MoveGenerator, perft) {
+        // https://www.chessprogramming.org/Perft_Results
+        auto start = fenGame("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        ASSERT_EQ(start.perft(3), 8902);
+        auto kiwipete = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        ASSERT_EQ(kiwipete.perft(2), 2039);
+        auto endgame = fenGame("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+        ASSERT_EQ(endgame.perft(4), 43238);
+        auto promotions = fenGame("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+        ASSERT_EQ(promotions.perft(3), 9467);
+        auto checks = fenGame("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+        ASSERT_EQ(checks.perft(2), 1486);
+    }
+
+    TEST(MoveGenerator, deepPerft) {
+        // the move lists of the earlier plies are reused after their moves are undone, so the undone moves must put
+        // back the same piece objects
+        auto kiwipete = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        ASSERT_EQ(kiwipete.perft(3), 97862);
+        ASSERT_EQ(kiwipete.perft(4), 4085603);
+        ASSERT_EQ(FENParser::gameToString(kiwipete), "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        auto promotions = fenGame("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+        ASSERT_EQ(promotions.perft(4), 422333);
+    }
+
+    TEST(MoveGenerator, isLegalAgreesWithGeneratedMoves) {
+        std::vector<Game> games = {
+                fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+                fenGame("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+                fenGame("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"),
+                fenGame("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"),
+                fenGame("8/8/8/K2pP2r/8/8/8/7k w - d6 0 1"),
+                fenGame("r3k2r/8/8/8/4Pp2/8/8/R3K2R b KQkq e3 0 1"),
+                fenGame("4k3/4r3/8/8/8/2B5/8/4K3 w - - 0 1"),
+        };
+        // and the positions after each move of kiwipete
+        for (const auto &move: games[0].getLegalMovesForPlayer(games[0].getCurrentPlayer())) {
+            Game child(games[0]);
+            child.makeMove(Move::fromPositions(child, move.getFrom(), move.getTo()));
+            games.push_back(child);
+        }
+        for (auto &game: games) {
+            auto legalMoves = game.getLegalMovesForPlayer(game.getCurrentPlayer());
+            for (int from = 0; from < 64; from++) {
+                if (game.getBoard()->getPiece(Square(from)) == nullptr) {
+                    continue;
+                }
+                for (int to = 0; to < 64; to++) {
+                    auto move = Move::fromPositions(game, Position(Square(from)), Position(Square(to)));
+                    auto generated = std::find(legalMoves.begin(), legalMoves.end(), move) != legalMoves.end();
+                    if (move.resultsInPromotion()) {
+                        ASSERT_FALSE(game.isLegal(move));
+                        move.setPromotion(PieceType::KNIGHT);
+                    }
+                    ASSERT_EQ(game.isLegal(move), generated) << FENParser::gameToString(game) << " "
+                                                             << move.toSmithNotation();
+                }
+            }
+        }
+    }
+
+    TEST(MoveGenerator, isLegalChecksThePiecesOfTheMove) {
+        auto game = fenGame("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2");
+        auto enPassant = Move::parseSmithNotation("e5d6", game);
+        ASSERT_TRUE(game.isLegal(enPassant));
+        ASSERT_FALSE(game.isLegal(Move(pos("e5"), pos("d6"), game.getPiece(pos("e5")))));
+        ASSERT_FALSE(game.isLegal(Move(pos("e2"), pos("e4"), game.getPiece(pos("d2")))));
+        ASSERT_TRUE(game.isLegal(Move::parseSmithNotation("g1f3", game)));
+        ASSERT_FALSE(game.isLegal(Move::parseSmithNotation("g8f6", game)));
+
+        auto promotion = fenGame("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+        ASSERT_TRUE(promotion.isLegal(Move::parseSmithNotation("b7b8q", promotion)));
+        ASSERT_FALSE(promotion.isLegal(Move::parseSmithNotation("b7b8", promotion)));
+        ASSERT_FALSE(promotion.isLegal(Move::parseSmithNotation("b7c8n", promotion)));
+
+        // castling rights without the rook, as a packed position may have them
+        CompactPosition position{};
+        ASSERT_FALSE(FENParser::parsePosition("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1", position));
+        position.squares[pos("h1").getIndex()] = NO_PIECE;
+        Game noRook(position);
+        ASSERT_FALSE(noRook.isLegal(Move::fromPositions(noRook, pos("e1"), pos("g1"))));
+        ASSERT_TRUE(noRook.isLegal(Move::fromPositions(noRook, pos("e1"), pos("c1"))));
+        ASSERT_EQ(noRook.getLegalMovesFrom(pos("e1")).size(), 6);
+    }
+
+    TEST(MoveGenerator, generationTypesPartitionMoves) {
+        auto game = fenGame("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        std::vector<Move> captures;
+        std::vector<Move> quiets;
+        std::vector<Move> all;
+        MoveGenerator::generateMoves(MoveGenerator::GenerationType::CAPTURES, *game.getBoard(), game.getGameState(),
+                                     captures);
+        MoveGenerator::generateMoves(MoveGenerator::GenerationType::QUIETS, *game.getBoard(), game.getGameState(),
+                                     quiets);
+        MoveGenerator::generateMoves(MoveGenerator::GenerationType::NON_EVASIONS, *game.getBoard(),
+                                     game.getGameState(), all);
+        ASSERT_EQ(captures.size() + quiets.size(), all.size());
+        for (const auto &move: captures) {
+            ASSERT_TRUE(move.isCapture());
+        }
+        for (const auto &move: quiets) {
+            ASSERT_FALSE(move.isCapture());
+        }
+    }
+
+    TEST(MoveGenerator, evasionsAnswerTheCheck) {
+        // the rook on e7 checks the king, the bishop can only block it on e5
+        auto game = fenGame("4k3/4r3/8/8/8/2B5/8/4K3 w - - 0 1");
+        std::vector<Move> evasions;
+        MoveGenerator::generateMoves(MoveGenerator::GenerationType::EVASIONS, *game.getBoard(), game.getGameState(),
+                                     evasions);
+        auto legal = game.getLegalMovesForPlayer(game.getCurrentPlayer());
+        ASSERT_EQ(legal.size(), 5);
+        for (const auto &move: evasions) {
+            if (move.getFrom() == pos("c3")) {
+                ASSERT_EQ(move.getTo(), pos("e5"));
+            }
+        }
+    }
+}
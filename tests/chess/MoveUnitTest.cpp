@@ -84,6 +84,20 @@ namespace MoveUnitTest {
         ASSERT_EQ(PieceType::QUEEN, move.getPromoteTo());
     }
 
+    TEST(Move, toSmithNotationPromotionNotChosen) {
+        auto game = fenGame("rnbqkb1r/pppp2Pp/4pp1n/8/7p/8/PPPPPP2/RNBQKBNR w KQkq - 0 6");
+        auto move = Move(pos("g7"), pos("g8"), game.getPiece(pos("g7")));
+        ASSERT_EQ("g7g8", move.toSmithNotation());
+        ASSERT_EQ("g7g8q", Move::parseSmithNotation("g7g8q", game).toSmithNotation());
+
+        std::vector<std::string> choices;
+        for (const auto &choice: move.withPromotionChoices()) {
+            choices.push_back(choice.toSmithNotation());
+        }
+        ASSERT_EQ(choices, std::vector<std::string>({"g7g8q", "g7g8r", "g7g8b", "g7g8n"}));
+        ASSERT_EQ(Move::parseSmithNotation("e2e4", game).withPromotionChoices().size(), 1);
+    }
+
     TEST(Move, parseSmithNotationNoPromotion) {
         auto game = Game();
         auto move = Move::parseSmithNotation("e2e4", game);
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "gtest/gtest.h"
+#include "PGNParser.h"
+#include "Game.h"
+#include "Move.h"
+#include "ChessExceptions.h"
+#include "pieces/PieceType.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace PGNParserUnitTest {
+    const std::string twoGames =
+            "[Event \"Casual\"]\n"
+            "[White \"Kasparov, \\\"Garry\\\"\"]\n"
+            "[Black \"Deep Blue\"]\n"
+            "[Result \"1-0\"]\n"
+            "\n"
+            "1. e4 {best by test} e5 2. Nf3 (2. f4 exf4 (2... d5)) Nc6 $1 3.Bb5 a6!? ; Ruy Lopez\n"
+            "4. Ba4 1-0\n"
+            "\n"
+            "[Event \"Casual\"]\n"
+            "[Result \"*\"]\n"
+            "\n"
+            "1. d4 d5 *\n";
+
+    TEST(PGNParser, splitGames) {
+        auto games = PGNParser::splitGames(twoGames);
+
+        ASSERT_EQ(2, games.size());
+        ASSERT_EQ(0, games[0].find("[Event"));
+        ASSERT_EQ(0, games[1].find("[Event"));
+        ASSERT_NE(std::string::npos, games[1].find("1. d4 d5 *"));
+    }
+
+    TEST(PGNParser, parseGame) {
+        auto games = PGNParser::parseGames(twoGames);
+        auto &game = games[0];
+
+        ASSERT_EQ(2, games.size());
+        ASSERT_EQ("Kasparov, \"Garry\"", game.getTag("White"));
+        ASSERT_EQ("", game.getTag("Site"));
+        std::vector<std::string> expectedMoves = {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6", "Ba4"};
+        ASSERT_EQ(expectedMoves, game.moves);
+        ASSERT_EQ("1-0", game.result);
+        ASSERT_EQ("*", games[1].result);
+    }
+
+    TEST(PGNParser, parseGameMalformed) {
+        ASSERT_THROW(PGNParser::parseGame("[White \"Unterminated]\n1. e4 *"), PgnException);
+        ASSERT_THROW(PGNParser::parseGame("1. e4 {comment *"), PgnException);
+        ASSERT_THROW(PGNParser::parseGame("1. e4 1-0 e5"), PgnException);
+    }
+
+    TEST(PGNParser, parseSan) {
+        auto game = fenGame("r3k2r/1P6/8/8/8/2N3N1/8/R3K2R w KQkq - 0 1");
+
+        auto knightMove = PGNParser::parseSan("Nce4", game);
+        ASSERT_EQ(pos("c3"), knightMove.getFrom());
+        ASSERT_EQ(pos("e4"), knightMove.getTo());
+
+        auto castling = PGNParser::parseSan("O-O-O", game);
+        ASSERT_TRUE(castling.isLongCastle());
+
+        auto promotion = PGNParser::parseSan("bxa8=Q+", game);
+        ASSERT_EQ(pos("a8"), promotion.getTo());
+        ASSERT_EQ(PieceType::QUEEN, promotion.getPromoteTo());
+        ASSERT_TRUE(promotion.isCapture());
+
+        ASSERT_THROW(PGNParser::parseSan("Ne4", game), IllegalMoveException);
+        ASSERT_THROW(PGNParser::parseSan("b8", game), IllegalMoveException);
+        ASSERT_THROW(PGNParser::parseSan("Ke3", game), IllegalMoveException);
+    }
+
+    TEST(PGNParser, moveToSan) {
+        auto game = fenGame("r3k2r/1P6/8/8/8/2N3N1/8/R3K2R w KQkq - 0 1");
+
+        ASSERT_EQ("Nce4", PGNParser::moveToSan(PGNParser::parseSan("Nce4", game), game));
+        ASSERT_EQ("Nf5", PGNParser::moveToSan(PGNParser::parseSan("Nf5", game), game));
+        ASSERT_EQ("O-O", PGNParser::moveToSan(PGNParser::parseSan("O-O", game), game));
+        ASSERT_EQ("bxa8=Q+", PGNParser::moveToSan(PGNParser::parseSan("bxa8=Q", game), game));
+        ASSERT_EQ("Rxa8+", PGNParser::moveToSan(PGNParser::parseSan("Rxa8", game), game));
+    }
+
+    TEST(PGNParser, gameToStringRoundTrip) {
+        auto game = PGNParser::parseGames(twoGames)[0];
+        auto copy = PGNParser::parseGame(PGNParser::gameToString(game));
+
+        ASSERT_EQ(game.tags, copy.tags);
+        ASSERT_EQ(game.moves, copy.moves);
+        ASSERT_EQ(game.result, copy.result);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "PackedPosition.h"
+#include "FENParser.h"
+#include "Game.h"
+#include "ChessExceptions.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace PackedPositionUnitTest {
+    const std::vector<std::string> positions = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 3 41",
+            "4k3/8/8/8/8/8/8/4K3 b - - 65535 65535",
+            "8/8/8/8/3pP3/8/8/k1K5 b - e3 0 1",
+    };
+
+    TEST(PackedPosition, losslessRoundTrip) {
+        for (const auto &fen: positions) {
+            auto game = fenGame(fen);
+            auto packed = PackedPosition::fromGame(game);
+            ASSERT_EQ(fen, ChessUnitTestCommon::fen(packed.toGame()));
+
+            CompactPosition position{};
+            ASSERT_FALSE(FENParser::parsePosition(fen, position));
+            ASSERT_EQ(packed, PackedPosition::pack(position));
+            auto unpacked = packed.unpack();
+            ASSERT_EQ(unpacked.squares, position.squares);
+            ASSERT_EQ(PackedPosition::pack(unpacked), packed);
+        }
+    }
+
+    TEST(PackedPosition, invalidPositions) {
+        CompactPosition crowded{};
+        ASSERT_FALSE(FENParser::parsePosition("nnnnnnnn/pppppppp/pppppppp/pppppppp/PPPPPPPP/8/8/k1K5 w - - 0 1", crowded));
+        ASSERT_THROW(PackedPosition::pack(crowded), ArchiveException);
+
+        auto packed = PackedPosition::fromGame(fenGame(positions[0]));
+        auto invalidPiece = packed;
+        invalidPiece.bytes[8] |= 0x7;
+        ASSERT_THROW(invalidPiece.unpack(), ArchiveException);
+        auto invalidEnPassant = packed;
+        invalidEnPassant.bytes[25] = 64;
+        ASSERT_THROW(invalidEnPassant.unpack(), ArchiveException);
+    }
+
+    TEST(PackedPosition, positionsBreakingTheRules) {
+        auto kings = PackedPosition::fromGame(fenGame(positions[2]));
+        auto enPassantWithoutPawn = kings;
+        enPassantWithoutPawn.bytes[25] = static_cast<uint8_t>(pos("e3").getIndex());
+        ASSERT_THROW(enPassantWithoutPawn.unpack(), ArchiveException);
+        auto castlingWithoutRook = kings;
+        castlingWithoutRook.bytes[24] |= GameState::WHITE_KINGSIDE << 1;
+        ASSERT_THROW(castlingWithoutRook.unpack(), ArchiveException);
+
+        auto enPassant = PackedPosition::fromGame(fenGame(positions[3]));
+        ASSERT_NO_THROW(enPassant.unpack());
+        auto enPassantOfTheOtherSide = enPassant;
+        enPassantOfTheOtherSide.bytes[24] ^= 1;
+        ASSERT_THROW(enPassantOfTheOtherSide.unpack(), ArchiveException);
+
+        PackedPosition empty{};
+        ASSERT_THROW(empty.unpack(), ArchiveException);
+        auto oneKing = kings;
+        // the black king is the second piece, in the upper half of the first code byte
+        auto blackQueen = makePieceCode(Color::BLACK, PieceType::QUEEN);
+        oneKing.bytes[8] = static_cast<uint8_t>((oneKing.bytes[8] & 0x0F) | blackQueen << 4);
+        ASSERT_THROW(oneKing.unpack(), ArchiveException);
+
+        CompactPosition pawnOnFirstRank{};
+        ASSERT_FALSE(FENParser::parsePosition(positions[2], pawnOnFirstRank));
+        pawnOnFirstRank.squares[pos("a1").getIndex()] = makePieceCode(Color::WHITE, PieceType::PAWN);
+        ASSERT_THROW(PackedPosition::pack(pawnOnFirstRank).unpack(), ArchiveException);
+    }
+
+    TEST(PackedPosition, fileOfPositions) {
+        auto path = testing::TempDir() + "PackedPositionUnitTest.cpos";
+        std::vector<CompactPosition> written(positions.size());
+        {
+            PackedPositionWriter writer(path);
+            for (size_t i = 0; i < positions.size(); i++) {
+                ASSERT_FALSE(FENParser::parsePosition(positions[i], written[i]));
+                writer.add(written[i]);
+            }
+        }
+
+        PackedPositionReader reader(path);
+        ASSERT_EQ(reader.getCount(), positions.size());
+        ASSERT_EQ(reader.getPosition(1), PackedPosition::pack(written[1]));
+        std::vector<CompactPosition> read(positions.size());
+        reader.unpack(0, read.size(), read.data());
+        for (size_t i = 0; i < read.size(); i++) {
+            ASSERT_EQ(read[i].squares, written[i].squares);
+            ASSERT_EQ(read[i].state.fullmoveNumber, written[i].state.fullmoveNumber);
+        }
+        ASSERT_THROW(reader.getPosition(positions.size()), ArchiveException);
+        ASSERT_THROW(reader.unpack(1, positions.size(), read.data()), ArchiveException);
+
+        {
+            std::ofstream truncated(path, std::ios::binary | std::ios::app);
+            truncated << "x";
+        }
+        ASSERT_THROW(PackedPositionReader invalid(path), ArchiveException);
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include "gtest/gtest.h"
+#include "PgnValidator.h"
+
+namespace PgnValidatorUnitTest {
+    std::string withFen(const std::string &fen, const std::string &movetext) {
+        return "[SetUp \"1\"]\n[FEN \"" + fen + "\"]\n\n" + movetext + "\n";
+    }
+
+    TEST(PgnValidator, validGame) {
+        auto report = PgnValidator::validateGame("[White \"Kasparov\"]\n[Black \"Deep Blue\"]\n[Result \"1-0\"]\n\n"
+                                                 "1. e4 e5 2. Qh5 Nc6 3. Bc4 Nf6 4. Qxf7# 1-0\n");
+        ASSERT_EQ(report.error, ValidationError::NONE);
+        ASSERT_EQ(report.players, "Kasparov - Deep Blue");
+        ASSERT_EQ(PgnValidator::errorName(report.error), "ok");
+    }
+
+    TEST(PgnValidator, decisiveResultAfterClaimableDraw) {
+        auto repetition = PgnValidator::validateGame("1. Nf3 Nf6 2. Ng1 Ng8 3. Nf3 Nf6 4. Ng1 Ng8 0-1\n");
+        ASSERT_EQ(repetition.error, ValidationError::NONE) << repetition.detail;
+
+        auto fiftyMoves = PgnValidator::validateGame(withFen("k7/8/8/8/8/8/8/KQ6 w - - 99 80", "80. Qb2 1-0"));
+        ASSERT_EQ(fiftyMoves.error, ValidationError::NONE) << fiftyMoves.detail;
+    }
+
+    TEST(PgnValidator, automaticEndingsDecideTheResult) {
+        auto mate = PgnValidator::validateGame("1. f3 e5 2. g4 Qh4# 1-0\n");
+        ASSERT_EQ(mate.error, ValidationError::WRONG_RESULT);
+        ASSERT_NE(mate.detail.find("expected 0-1"), std::string::npos);
+
+        auto stalemate = PgnValidator::validateGame(withFen("k7/8/1Q6/8/8/8/8/7K w - - 0 1", "1. Qc7 1-0"));
+        ASSERT_EQ(stalemate.error, ValidationError::WRONG_RESULT);
+        ASSERT_NE(stalemate.detail.find("stalemate"), std::string::npos);
+
+        auto drawnStalemate = PgnValidator::validateGame(withFen("k7/8/1Q6/8/8/8/8/7K w - - 0 1", "1. Qc7 1/2-1/2"));
+        ASSERT_EQ(drawnStalemate.error, ValidationError::NONE);
+
+        auto bareKings = PgnValidator::validateGame(withFen("k7/8/8/8/8/8/1q6/K7 w - - 0 1", "1. Kxb2 0-1"));
+        ASSERT_EQ(bareKings.error, ValidationError::WRONG_RESULT);
+        ASSERT_NE(bareKings.detail.find("insufficient material"), std::string::npos);
+    }
+
+    TEST(PgnValidator, invalidGames) {
+        ASSERT_EQ(PgnValidator::validateGame("1. e4 e5 2. Ke3 *\n").error, ValidationError::ILLEGAL_MOVE);
+        ASSERT_EQ(PgnValidator::validateGame("1. e4 e5\n").error, ValidationError::WRONG_RESULT);
+        ASSERT_EQ(PgnValidator::validateGame("[Result \"0-1\"]\n\n1. e4 e5 1-0\n").error,
+                  ValidationError::WRONG_RESULT);
+        ASSERT_EQ(PgnValidator::validateGame(withFen("k7/8/8/8/8/8/8/7P w - - 0 1", "*")).error,
+                  ValidationError::BAD_FEN);
+        ASSERT_EQ(PgnValidator::validateGame("[White \"unterminated\n\n1. e4 *\n").error,
+                  ValidationError::PARSE_ERROR);
+    }
+}
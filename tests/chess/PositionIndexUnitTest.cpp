@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "PositionIndex.h"
+#include "GameArchive.h"
+#include "PGNParser.h"
+#include "FENParser.h"
+#include "Zobrist.h"
+#include "Game.h"
+#include "Move.h"
+#include "ChessExceptions.h"
+#include "common.h"
+
+using namespace ChessUnitTestCommon;
+
+namespace PositionIndexUnitTest {
+    ArchivedGame archived(const std::string &pgn) {
+        return GameArchive::fromPgn(PGNParser::parseGame(pgn));
+    }
+
+    TEST(Zobrist, transpositionsHaveEqualHashes) {
+        auto first = archived("1. e4 e5 2. Nf3 *");
+        auto second = archived("1. Nf3 e5 2. e4 *");
+        uint64_t firstHash = 0, secondHash = 0;
+        GameArchive::replay(first, [&firstHash](const Game &game, size_t) { firstHash = Zobrist::hash(game); });
+        GameArchive::replay(second, [&secondHash](const Game &game, size_t) { secondHash = Zobrist::hash(game); });
+
+        ASSERT_EQ(firstHash, secondHash);
+        ASSERT_EQ(Zobrist::hash(fenGame("rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2")), firstHash);
+    }
+
+    TEST(Zobrist, sideCastlingAndEnPassant) {
+        auto hash = Zobrist::hash(fenGame("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1"));
+        ASSERT_NE(hash, Zobrist::hash(fenGame("4k3/8/8/8/8/8/8/R3K2R b KQ - 0 1")));
+        ASSERT_NE(hash, Zobrist::hash(fenGame("4k3/8/8/8/8/8/8/R3K2R w K - 0 1")));
+
+        // en passant target only matters if the capture is possible
+        ASSERT_EQ(Zobrist::hash(fenGame("4k3/8/8/8/4P3/8/8/4K3 b - e3 0 1")),
+                  Zobrist::hash(fenGame("4k3/8/8/8/4P3/8/8/4K3 b - - 0 1")));
+        ASSERT_NE(Zobrist::hash(fenGame("4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1")),
+                  Zobrist::hash(fenGame("4k3/8/8/8/3pP3/8/8/4K3 b - - 0 1")));
+    }
+
+    void expectIncrementalHash(Game &game, int depth) {
+        ASSERT_EQ(game.getHash(), Zobrist::hash(game)) << FENParser::gameToString(game);
+        if (depth == 0) {
+            return;
+        }
+        for (const auto &generated: game.getLegalMovesForPlayer(game.getCurrentPlayer())) {
+            for (const auto &move: generated.withPromotionChoices()) {
+                game.makeMove(move);
+                expectIncrementalHash(game, depth - 1);
+                game.undoMove();
+            }
+        }
+    }
+
+    TEST(Zobrist, makeMoveUpdatesTheHash) {
+        // castlings, en passant captures and promotions with and without a capture
+        for (auto fen: {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+            auto game = fenGame(fen);
+            expectIncrementalHash(game, 2);
+        }
+    }
+
+    TEST(PositionIndex, findPositions) {
+        auto path = testing::TempDir() + "PositionIndexUnitTest.cpi";
+        {
+            // tiny runs force the external merge
+            PositionIndexBuilder builder(path, 3);
+            builder.addGame(archived("1. e4 e5 2. Nf3 *"), 0);
+            builder.addGame(archived("1. d4 d5 *"), 1);
+            builder.addGame(archived("1. Nf3 e5 2. e4 Nc6 *"), 2);
+            builder.finish();
+        }
+
+        PositionIndexReader reader(path);
+        ASSERT_EQ(12, reader.getPostingCount());
+        ASSERT_EQ(9, reader.getPositionCount());
+
+        auto start = reader.find(Game());
+        ASSERT_EQ((std::vector<PositionMatch>{{0, 0}, {1, 0}, {2, 0}}), start);
+
+        auto transposed = reader.findFen("rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+        ASSERT_EQ((std::vector<PositionMatch>{{0, 3}, {2, 3}}), transposed);
+
+        ASSERT_TRUE(reader.findFen("4k3/8/8/8/8/8/8/4K3 w - - 0 1").empty());
+        ASSERT_THROW(reader.findFen("not a fen"), FenException);
+        std::remove(path.c_str());
+    }
+
+    TEST(PositionIndex, inMemoryBuildMatchesExternalSort) {
+        auto inMemoryPath = testing::TempDir() + "PositionIndexUnitTestMemory.cpi";
+        auto externalPath = testing::TempDir() + "PositionIndexUnitTestExternal.cpi";
+        auto game = archived("1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 4. Ba4 Nf6 5. O-O Be7 *");
+        {
+            PositionIndexBuilder inMemory(inMemoryPath);
+            PositionIndexBuilder external(externalPath, 2);
+            for (uint32_t i = 0; i < 5; i++) {
+                inMemory.addGame(game, i);
+                external.addGame(game, i);
+            }
+            inMemory.finish();
+            external.finish();
+        }
+
+        std::ifstream first(inMemoryPath, std::ios::binary);
+        std::ifstream second(externalPath, std::ios::binary);
+        std::string firstContent((std::istreambuf_iterator<char>(first)), std::istreambuf_iterator<char>());
+        std::string secondContent((std::istreambuf_iterator<char>(second)), std::istreambuf_iterator<char>());
+        ASSERT_EQ(firstContent, secondContent);
+        std::remove(inMemoryPath.c_str());
+        std::remove(externalPath.c_str());
+    }
+
+    TEST(PositionIndex, invalidFile) {
+        auto path = testing::TempDir() + "PositionIndexUnitTestInvalid.cpi";
+        {
+            std::ofstream file(path);
+            file << "definitely not a position index file";
+        }
+
+        ASSERT_THROW(PositionIndexReader reader(path), ArchiveException);
+        ASSERT_THROW(PositionIndexReader reader(path + ".missing"), ArchiveException);
+        std::remove(path.c_str());
+    }
+}
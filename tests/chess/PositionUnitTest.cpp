@@ -42,4 +42,22 @@ namespace PositionUnitTest {
         ASSERT_THROW(Position::fromString("j3"), std::invalid_argument);
         ASSERT_THROW(Position::fromString("a0"), std::invalid_argument);
     }
-}
\ No newline at end of file
+
+    TEST(Position, squareConversion) {
+        ASSERT_EQ(Position(1, 1).toSquare(), Square::at(0, 0));
+        ASSERT_EQ(Position(4, 5).toSquare().getIndex(), Position(4, 5).getIndex());
+        for (int index = 0; index < 64; index++) {
+            ASSERT_EQ(Position(Square(index)).toSquare().getIndex(), index);
+        }
+    }
+
+    TEST(Square, offsetOffTheBoard) {
+        auto h8 = Square::at(7, 7);
+        ASSERT_FALSE(h8.offset(1, 0).isValid());
+        ASSERT_FALSE(h8.offset(0, 1).isValid());
+        ASSERT_FALSE(Square::at(0, 0).offset(-1, -2).isValid());
+        ASSERT_EQ(h8.offset(-2, -1), Square::at(5, 6));
+        ASSERT_FALSE(Square(-1).isValid());
+        ASSERT_FALSE(Square().isValid());
+    }
+}
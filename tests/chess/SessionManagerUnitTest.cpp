@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2023.
+ * Maksym Bieńkowski
+ * Mikołaj Garbowski
+ * Michał Łuszczek
+ */
+
+#include <thread>
+#include "gtest/gtest.h"
+#include "SessionManager.h"
+
+namespace SessionManagerUnitTest {
+    std::string run(SessionManager &manager, const std::string &command) {
+        return manager.execute(command).get();
+    }
+
+    TEST(SessionManager, playAGame) {
+        SessionManager manager(2);
+        auto id = run(manager, "create").substr(3);
+        auto other = run(manager, "create 4k3/8/8/8/8/8/8/4K2R w K - 0 1").substr(3);
+        ASSERT_NE(id, other);
+
+        ASSERT_EQ(run(manager, "moves " + id).size(), std::string("ok").size() + 20 * 5);
+        for (auto move: {"f2f3", "e7e5", "g2g4", "d8h4"}) {
+            ASSERT_EQ(run(manager, "move " + id + " " + move), "ok");
+        }
+        ASSERT_EQ(run(manager, "status " + id), "ok mate w");
+        ASSERT_EQ(run(manager, "moves " + id), "ok");
+        ASSERT_EQ(run(manager, "fen " + id), "ok rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+
+        ASSERT_EQ(run(manager, "move " + other + " e1g1"), "ok");
+        ASSERT_EQ(run(manager, "fen " + other), "ok 4k3/8/8/8/8/8/8/5RK1 b - - 1 1");
+        ASSERT_EQ(run(manager, "status " + other), "ok playing b");
+
+        auto stats = manager.getStats();
+        ASSERT_EQ(stats.games, 2);
+        ASSERT_EQ(stats.moves, 5);
+        ASSERT_EQ(run(manager, "close " + other), "ok");
+        ASSERT_EQ(manager.getStats().games, 1);
+        ASSERT_EQ(run(manager, "stats").rfind("ok games=1 moves=5 ", 0), 0);
+    }
+
+    TEST(SessionManager, errorReplies) {
+        SessionManager manager(1);
+        auto id = run(manager, "create").substr(3);
+        ASSERT_EQ(run(manager, "move " + id + " e2e5"), "error Illegal move e2e5");
+        ASSERT_EQ(run(manager, "move " + id + " e7e5"), "error Illegal move e7e5");
+        ASSERT_EQ(run(manager, "fen 12345"), "error No session 12345");
+        ASSERT_EQ(run(manager, "fen x"), "error Invalid session id");
+        ASSERT_EQ(run(manager, "undo " + id), "error Unknown command undo");
+        ASSERT_EQ(run(manager, ""), "error Empty command");
+        ASSERT_EQ(run(manager, "create 8/8/8 w - - 0 1").rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(run(manager, "fen " + id), "ok rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        ASSERT_EQ(manager.getStats().moves, 0);
+    }
+
+    TEST(SessionManager, badClientInput) {
+        SessionManager manager(1);
+        // castling rights without the rook or with the king off its field
+        ASSERT_EQ(run(manager, "create 4k3/8/8/8/8/8/8/R3K3 w KQ - 0 1").rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(run(manager, "create 4k3/8/8/8/8/8/8/3K3R w K - 0 1").rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(run(manager, "create 4k3/8/8/8/8/8/8/4K2p b - - 0 1").rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(run(manager, "create 4k3/8/8/8/8/8/8/4K3 w - - 0 1 trailing").rfind("error Invalid FEN", 0), 0);
+
+        auto id = run(manager, "create 4k3/6P1/8/8/8/8/8/4K3 w - - 0 1").substr(3);
+        ASSERT_EQ(run(manager, "moves " + id), "ok e1d1 e1f1 e1d2 e1e2 e1f2 g7g8q g7g8r g7g8b g7g8n");
+        ASSERT_EQ(run(manager, "move " + id + " g7g8"), "error Illegal move g7g8");
+        ASSERT_EQ(run(manager, "move " + id + " g7g8k"), "error Invalid promotion piece");
+        ASSERT_EQ(run(manager, "move " + id + " e1e2q"), "error Non-pawn pieces cannot promote!");
+        ASSERT_EQ(run(manager, "move " + id + " e3e4"), "error Cannot move from empty field");
+        ASSERT_EQ(run(manager, "move " + id + " e1e3"), "error Illegal move e1e3");
+        ASSERT_EQ(run(manager, "move " + id + " e1"), "error Invalid representation of a move");
+        ASSERT_EQ(run(manager, "move " + id), "error Invalid representation of a move");
+        ASSERT_EQ(run(manager, "move " + id + " e1e2 e8e7"), "error Invalid representation of a move");
+        ASSERT_EQ(run(manager, "move " + id + " z9z8").rfind("error ", 0), 0);
+        ASSERT_EQ(run(manager, "move " + id + " 18446744073709551616"), "error Invalid representation of a move");
+        ASSERT_EQ(run(manager, "fen " + id), "ok 4k3/6P1/8/8/8/8/8/4K3 w - - 0 1");
+
+        ASSERT_EQ(run(manager, "move " + id + " g7g8n"), "ok");
+        ASSERT_EQ(run(manager, "fen " + id), "ok 4k1N1/8/8/8/8/8/8/4K3 b - - 0 1");
+        // a knight against a bare king is a draw
+        ASSERT_EQ(run(manager, "move " + id + " e8e7"), "error The game is over");
+        ASSERT_EQ(run(manager, "status 99999999999999999999"), "error Invalid session id");
+        ASSERT_EQ(manager.getStats().moves, 1);
+    }
+
+    TEST(SessionManager, createRefusesImpossibleEnPassant) {
+        SessionManager manager(1);
+        ASSERT_EQ(run(manager, "create 4k3/8/8/8/8/8/8/4K3 w - e3 0 1").rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(run(manager, "create rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e6 0 1")
+                          .rfind("error Invalid FEN", 0), 0);
+        ASSERT_EQ(manager.getStats().games, 0);
+
+        // the ids taken by the refused commands have no sessions
+        auto id = std::stoull(run(manager, "create").substr(3));
+        ASSERT_EQ(id, 3);
+        for (uint64_t refused: {1, 2}) {
+            auto idString = std::to_string(refused);
+            ASSERT_EQ(run(manager, "move " + idString + " e1e2"), "error No session " + idString);
+            ASSERT_EQ(run(manager, "fen " + idString), "error No session " + idString);
+        }
+        ASSERT_EQ(manager.getStats().games, 1);
+    }
+
+    TEST(SessionManager, repetitionAcrossCommands) {
+        SessionManager manager(1);
+        auto id = run(manager, "create").substr(3);
+        for (int i = 0; i < 2; i++) {
+            for (auto move: {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+                // a failed command gives the recorded moves back to the session
+                ASSERT_EQ(run(manager, "move " + id + " e2e5"), "error Illegal move e2e5");
+                ASSERT_EQ(run(manager, "move " + id + " " + move), "ok");
+            }
+        }
+        ASSERT_EQ(run(manager, "status " + id), "ok threefold-repetition w");
+        ASSERT_EQ(run(manager, "move " + id + " e2e4"), "error The game is over");
+        ASSERT_EQ(run(manager, "fen " + id), "ok rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 8 5");
+        ASSERT_EQ(run(manager, "status " + id), "ok threefold-repetition w");
+    }
+
+    TEST(SessionManager, gamesOnManyThreads) {
+        SessionManager manager(4);
+        std::vector<std::thread> clients;
+        for (int client = 0; client < 8; client++) {
+            clients.emplace_back([&manager]() {
+                std::vector<std::string> ids;
+                for (int i = 0; i < 25; i++) {
+                    ids.push_back(manager.execute("create").get().substr(3));
+                }
+                for (auto move: {"e2e4", "e7e5", "g1f3", "b8c6"}) {
+                    std::vector<std::future<std::string>> replies;
+                    for (const auto &id: ids) {
+                        replies.push_back(manager.execute("move " + id + " " + move));
+                    }
+                    for (auto &reply: replies) {
+                        EXPECT_EQ(reply.get(), "ok");
+                    }
+                }
+                for (const auto &id: ids) {
+                    EXPECT_EQ(manager.execute("fen " + id).get(),
+                              "ok r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+                }
+            });
+        }
+        for (auto &client: clients) {
+            client.join();
+        }
+
+        auto stats = manager.getStats();
+        ASSERT_EQ(stats.games, 200);
+        ASSERT_EQ(stats.moves, 800);
+        ASSERT_EQ(stats.commands, 8 * (25 + 4 * 25 + 25));
+    }
+
+    TEST(LatencyHistogram, percentiles) {
+        LatencyHistogram histogram;
+        ASSERT_EQ(histogram.percentile(0.99), 0);
+        for (uint64_t microseconds = 1; microseconds <= 1000; microseconds++) {
+            histogram.record(microseconds);
+        }
+        ASSERT_EQ(histogram.getCount(), 1000);
+        ASSERT_EQ(histogram.percentile(0.05), 50);
+        // 990 is in the bucket of 960-1023
+        ASSERT_EQ(histogram.percentile(0.99), 1023);
+        histogram.record(UINT64_MAX);
+        ASSERT_EQ(histogram.percentile(1), UINT64_MAX);
+    }
+}